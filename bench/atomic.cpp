@@ -0,0 +1,124 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Cost of the atomic_* functions on a single thread, compared with their
+// std::shared_ptr overloads. Each std_* benchmark is followed by its throwing
+// counterpart, then by the same operation on throwing::atomic_shared_ptr.
+
+#include "atomic_adapters.hpp"
+#include "bench.hpp"
+#include <memory>
+#include <throwing/shared_ptr.hpp>
+
+namespace {
+
+template <typename Pointer> void load_loop(bench::state &s, Pointer &ptr) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(atomic_load(&ptr));
+    }
+}
+
+template <typename Target, typename Pointer>
+void store_loop(bench::state &s, Target &ptr, const Pointer &value) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        atomic_store(&ptr, value);
+        bench::clobber_memory();
+    }
+}
+
+template <typename Target, typename Pointer>
+void exchange_loop(bench::state &s, Target &ptr, Pointer value) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        value = atomic_exchange(&ptr, value);
+        bench::do_not_optimize(value);
+    }
+}
+
+template <typename Target, typename Pointer>
+void compare_exchange_loop(bench::state &s, Target &ptr, Pointer value) {
+    Pointer expected = atomic_load(&ptr);
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        // Alternates between a successful and a failed exchange
+        bench::do_not_optimize(
+                atomic_compare_exchange_strong(&ptr, &expected, value));
+    }
+}
+
+void std_shared_ptr_atomic_load(bench::state &s) {
+    auto ptr = std::make_shared<int>(42);
+    load_loop(s, ptr);
+}
+BENCHMARK(std_shared_ptr_atomic_load);
+
+void shared_ptr_atomic_load(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    load_loop(s, ptr);
+}
+BENCHMARK(shared_ptr_atomic_load);
+
+void atomic_shared_ptr_load(bench::state &s) {
+    throwing::atomic_shared_ptr<int> ptr(throwing::make_shared<int>(42));
+    load_loop(s, ptr);
+}
+BENCHMARK(atomic_shared_ptr_load);
+
+void std_shared_ptr_atomic_store(bench::state &s) {
+    auto ptr = std::make_shared<int>(42);
+    auto value = std::make_shared<int>(43);
+    store_loop(s, ptr, value);
+}
+BENCHMARK(std_shared_ptr_atomic_store);
+
+void shared_ptr_atomic_store(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    auto value = throwing::make_shared<int>(43);
+    store_loop(s, ptr, value);
+}
+BENCHMARK(shared_ptr_atomic_store);
+
+void atomic_shared_ptr_store(bench::state &s) {
+    throwing::atomic_shared_ptr<int> ptr(throwing::make_shared<int>(42));
+    auto value = throwing::make_shared<int>(43);
+    store_loop(s, ptr, value);
+}
+BENCHMARK(atomic_shared_ptr_store);
+
+void std_shared_ptr_atomic_exchange(bench::state &s) {
+    auto ptr = std::make_shared<int>(42);
+    exchange_loop(s, ptr, std::make_shared<int>(43));
+}
+BENCHMARK(std_shared_ptr_atomic_exchange);
+
+void shared_ptr_atomic_exchange(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    exchange_loop(s, ptr, throwing::make_shared<int>(43));
+}
+BENCHMARK(shared_ptr_atomic_exchange);
+
+void atomic_shared_ptr_exchange(bench::state &s) {
+    throwing::atomic_shared_ptr<int> ptr(throwing::make_shared<int>(42));
+    exchange_loop(s, ptr, throwing::make_shared<int>(43));
+}
+BENCHMARK(atomic_shared_ptr_exchange);
+
+void std_shared_ptr_atomic_compare_exchange_strong(bench::state &s) {
+    auto ptr = std::make_shared<int>(42);
+    compare_exchange_loop(s, ptr, std::make_shared<int>(43));
+}
+BENCHMARK(std_shared_ptr_atomic_compare_exchange_strong);
+
+void shared_ptr_atomic_compare_exchange_strong(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    compare_exchange_loop(s, ptr, throwing::make_shared<int>(43));
+}
+BENCHMARK(shared_ptr_atomic_compare_exchange_strong);
+
+void atomic_shared_ptr_compare_exchange_strong(bench::state &s) {
+    throwing::atomic_shared_ptr<int> ptr(throwing::make_shared<int>(42));
+    compare_exchange_loop(s, ptr, throwing::make_shared<int>(43));
+}
+BENCHMARK(atomic_shared_ptr_compare_exchange_strong);
+
+} // namespace
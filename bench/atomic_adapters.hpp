@@ -0,0 +1,46 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Overloads of the atomic_* functions for throwing::atomic_shared_ptr, so that
+// the benchmarks of the atomic_* functions can run on it unchanged. They must
+// be declared before the benchmark templates that call them.
+
+#pragma once
+#include <memory>
+#include <throwing/atomic_shared_ptr.hpp>
+#include <throwing/shared_ptr.hpp>
+
+/** \brief Type of the pointers stored into and loaded from a Target */
+template <typename Target> struct atomic_value {
+    typedef Target type;
+};
+
+template <typename T> struct atomic_value<throwing::atomic_shared_ptr<T>> {
+    typedef throwing::shared_ptr<T> type;
+};
+
+template <typename T>
+throwing::shared_ptr<T> atomic_load(const throwing::atomic_shared_ptr<T> *p) {
+    return p->load();
+}
+
+template <typename T>
+void atomic_store(throwing::atomic_shared_ptr<T> *p,
+                  throwing::shared_ptr<T> value) {
+    p->store(std::move(value));
+}
+
+template <typename T>
+throwing::shared_ptr<T> atomic_exchange(throwing::atomic_shared_ptr<T> *p,
+                                        throwing::shared_ptr<T> value) {
+    return p->exchange(std::move(value));
+}
+
+template <typename T>
+bool atomic_compare_exchange_strong(throwing::atomic_shared_ptr<T> *p,
+                                    throwing::shared_ptr<T> *expected,
+                                    throwing::shared_ptr<T> desired) {
+    return p->compare_exchange_strong(*expected, std::move(desired));
+}
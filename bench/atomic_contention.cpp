@@ -0,0 +1,439 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Throughput and latency of the atomic_* functions under contention.
+//
+// For 1 to N threads, each workload runs on a single pointer shared by all
+// threads, then on one independent pointer per thread. With the std
+// implementation in libstdc++, which protects shared_ptr objects with a small
+// pool of mutexes picked by address, independent pointers can still contend.
+// Each workload runs for std::shared_ptr, for throwing::shared_ptr and for
+// throwing::atomic_shared_ptr.
+//
+// Then threads lock a single weak pointer, held by a throwing::atomic_weak_ptr
+// or guarded by a mutex, with and without threads storing into it.
+//
+// One operation out of sixteen is timed individually to estimate the latency
+// percentiles; throughput is measured on all operations.
+//
+// Usage: throwing_ptr_atomic_bench [--threads=N] [--seconds=S]
+//                                  [--json[=file]] [filter]
+
+#include "atomic_adapters.hpp"
+#include "bench.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <throwing/atomic_weak_ptr.hpp>
+#include <throwing/shared_ptr.hpp>
+#include <vector>
+
+// Not counted here, see bench/main.cpp
+std::uint64_t bench::thread_allocations() { return 0; }
+
+namespace {
+
+typedef std::chrono::steady_clock bench_clock;
+
+enum workload { load, store, exchange, compare_exchange, mixed };
+
+const char *workload_name(workload w) {
+    switch (w) {
+    case load:
+        return "load";
+    case store:
+        return "store";
+    case exchange:
+        return "exchange";
+    case compare_exchange:
+        return "compare_exchange";
+    case mixed:
+        return "mixed";
+    }
+    return "";
+}
+
+/** \brief A pointer alone on its cache line */
+template <typename Pointer> struct alignas(64) slot { Pointer p; };
+
+/** \brief Results of one thread */
+struct thread_result {
+    std::uint64_t operations = 0;
+    std::vector<std::uint32_t> latencies;
+};
+
+const std::size_t max_latency_samples = std::size_t(1) << 20;
+const unsigned sampling_mask = 15;
+
+template <typename Target, typename Pointer>
+void run_operation(workload w, bool reader, Target &target, Pointer &expected,
+                   const Pointer &value) {
+    switch (w) {
+    case load:
+        bench::do_not_optimize(atomic_load(&target));
+        break;
+    case store:
+        atomic_store(&target, value);
+        break;
+    case exchange:
+        bench::do_not_optimize(atomic_exchange(&target, value));
+        break;
+    case compare_exchange:
+        // On failure expected is updated, so that the next attempt can win
+        bench::do_not_optimize(
+                atomic_compare_exchange_strong(&target, &expected, value));
+        break;
+    case mixed:
+        if (reader)
+            bench::do_not_optimize(atomic_load(&target));
+        else
+            atomic_store(&target, value);
+        break;
+    }
+}
+
+/** \brief One of the atomic_* workloads on target, run by one thread */
+template <typename Target> struct atomic_operation {
+    typedef typename atomic_value<Target>::type Pointer;
+
+    atomic_operation(workload w, bool reader, Target &target)
+            : w(w), reader(reader), target(target), value(new int(42)),
+              expected(atomic_load(&target)) {}
+
+    void operator()() { run_operation(w, reader, target, expected, value); }
+
+    workload w;
+    bool reader;
+    Target &target;
+    Pointer value;
+    Pointer expected;
+};
+
+template <typename Operation>
+void thread_body(Operation &operation, const std::atomic<bool> &start,
+                 const std::atomic<bool> &stop, thread_result &result) {
+    result.latencies.reserve(max_latency_samples);
+    while (!start.load(std::memory_order_acquire)) {
+    }
+    std::uint64_t operations = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        if ((operations & sampling_mask) == 0 &&
+            result.latencies.size() < max_latency_samples) {
+            const auto before = bench_clock::now();
+            operation();
+            const auto after = bench_clock::now();
+            result.latencies.push_back(static_cast<std::uint32_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            after - before)
+                            .count()));
+        } else {
+            operation();
+        }
+        ++operations;
+    }
+    result.operations = operations;
+}
+
+struct measurement {
+    std::string name;
+    unsigned threads;
+    double operations_per_second;
+    std::uint32_t p50;
+    std::uint32_t p99;
+    std::uint32_t p999;
+    std::uint32_t max;
+};
+
+std::uint32_t percentile(const std::vector<std::uint32_t> &sorted, double p) {
+    if (sorted.empty())
+        return 0;
+    const double last = static_cast<double>(sorted.size() - 1);
+    return sorted[static_cast<std::size_t>(p * last)];
+}
+
+/** \brief Runs threads, the i-th running make_operation(i) in a loop */
+template <typename MakeOperation>
+measurement run_threads(const std::string &name, unsigned threads,
+                        double seconds, MakeOperation make_operation) {
+    std::vector<thread_result> results(threads);
+    std::atomic<bool> start(false);
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i] {
+            auto operation = make_operation(i);
+            thread_body(operation, start, stop, results[i]);
+        });
+    }
+
+    const auto begin = bench_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true, std::memory_order_relaxed);
+    for (auto &worker : workers)
+        worker.join();
+    const double elapsed =
+            std::chrono::duration<double>(bench_clock::now() - begin).count();
+
+    std::uint64_t operations = 0;
+    std::vector<std::uint32_t> latencies;
+    for (const auto &r : results) {
+        operations += r.operations;
+        latencies.insert(latencies.end(), r.latencies.begin(),
+                         r.latencies.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    measurement m;
+    m.name = name;
+    m.threads = threads;
+    m.operations_per_second = static_cast<double>(operations) / elapsed;
+    m.p50 = percentile(latencies, 0.5);
+    m.p99 = percentile(latencies, 0.99);
+    m.p999 = percentile(latencies, 0.999);
+    m.max = latencies.empty() ? 0 : latencies.back();
+    return m;
+}
+
+template <typename Target>
+measurement run(const std::string &name, workload w, bool independent,
+                unsigned threads, double seconds) {
+    typedef typename atomic_value<Target>::type Pointer;
+    std::vector<slot<Target>> slots(independent ? threads : 1);
+    for (auto &s : slots)
+        s.p = Pointer(new int(0));
+    return run_threads(name, threads, seconds, [&](unsigned i) {
+        return atomic_operation<Target>(w, i % 2 == 0,
+                                        slots[independent ? i : 0].p);
+    });
+}
+
+/** \brief A weak_ptr guarded by a mutex, as shared between threads without
+ * atomic_weak_ptr
+ */
+struct mutex_weak_ptr {
+    std::mutex m;
+    throwing::weak_ptr<int> p;
+};
+
+throwing::shared_ptr<int> lock_weak(mutex_weak_ptr &target) {
+    std::lock_guard<std::mutex> guard(target.m);
+    return target.p.lock();
+}
+
+void store_weak(mutex_weak_ptr &target,
+                const throwing::shared_ptr<int> &owner) {
+    throwing::weak_ptr<int> replaced(owner);
+    {
+        std::lock_guard<std::mutex> guard(target.m);
+        swap(target.p, replaced);
+    }
+}
+
+throwing::shared_ptr<int> lock_weak(throwing::atomic_weak_ptr<int> &target) {
+    return target.lock();
+}
+
+void store_weak(throwing::atomic_weak_ptr<int> &target,
+                const throwing::shared_ptr<int> &owner) {
+    target.store(owner);
+}
+
+/** \brief Locks the weak pointer in target or, for writers, points it to an
+ * object owned by the thread
+ */
+template <typename Target> struct weak_operation {
+    weak_operation(bool reader, Target &target)
+            : reader(reader), target(target), owner(new int(42)) {}
+
+    void operator()() {
+        if (reader)
+            bench::do_not_optimize(lock_weak(target));
+        else
+            store_weak(target, owner);
+    }
+
+    bool reader;
+    Target &target;
+    throwing::shared_ptr<int> owner;
+};
+
+/** \brief Runs threads locking one weak pointer; with writers, half of the
+ * threads store into it instead
+ */
+template <typename Target>
+measurement run_weak(const std::string &name, bool writers, unsigned threads,
+                     double seconds) {
+    slot<Target> target;
+    const throwing::shared_ptr<int> initial(new int(0));
+    store_weak(target.p, initial);
+    return run_threads(name, threads, seconds, [&](unsigned i) {
+        return weak_operation<Target>(!writers || i % 2 == 0, target.p);
+    });
+}
+
+const char *const implementation_names[] = {"std_shared_ptr_atomic_",
+                                            "shared_ptr_atomic_",
+                                            "atomic_shared_ptr_"};
+
+measurement run_implementation(int implementation, const std::string &name,
+                               workload w, bool independent, unsigned threads,
+                               double seconds) {
+    switch (implementation) {
+    case 0:
+        return run<std::shared_ptr<int>>(name, w, independent, threads,
+                                         seconds);
+    case 1:
+        return run<throwing::shared_ptr<int>>(name, w, independent, threads,
+                                              seconds);
+    default:
+        return run<throwing::atomic_shared_ptr<int>>(name, w, independent,
+                                                     threads, seconds);
+    }
+}
+
+void write_json(std::FILE *out, const std::vector<measurement> &results) {
+    std::fprintf(out, "{\n  \"benchmarks\": [");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const measurement &m = results[i];
+        std::fprintf(out, "%s\n    {\n", i ? "," : "");
+        std::fprintf(out, "      \"name\": \"%s\",\n", m.name.c_str());
+        std::fprintf(out, "      \"threads\": %u,\n", m.threads);
+        std::fprintf(out, "      \"items_per_second\": %.1f,\n",
+                     m.operations_per_second);
+        std::fprintf(out, "      \"p50_ns\": %u,\n", m.p50);
+        std::fprintf(out, "      \"p99_ns\": %u,\n", m.p99);
+        std::fprintf(out, "      \"p999_ns\": %u,\n", m.p999);
+        std::fprintf(out, "      \"max_ns\": %u\n", m.max);
+        std::fprintf(out, "    }");
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+void print_usage(const char *program) {
+    std::fprintf(stderr,
+                 "usage: %s [--threads=N] [--seconds=S] [--json[=file]] "
+                 "[filter]\n",
+                 program);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    unsigned max_threads = std::max(2u, std::thread::hardware_concurrency());
+    double seconds = 0.2;
+    const char *filter = nullptr;
+    bool json = false;
+    const char *json_file = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            max_threads = static_cast<unsigned>(std::atoi(argv[i] + 10));
+        } else if (std::strncmp(argv[i], "--seconds=", 10) == 0) {
+            seconds = std::atof(argv[i] + 10);
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (std::strncmp(argv[i], "--json=", 7) == 0) {
+            json = true;
+            json_file = argv[i] + 7;
+        } else if (argv[i][0] == '-' || filter) {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        } else {
+            filter = argv[i];
+        }
+    }
+    if (max_threads == 0 || seconds <= 0) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < max_threads; t *= 2)
+        thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+
+    // The table goes to stderr when the JSON goes to stdout
+    std::FILE *table = json && !json_file ? stderr : stdout;
+    std::fprintf(table, "%-48s %8s %12s %9s %9s %9s %9s\n", "benchmark",
+                 "threads", "Mops/s", "p50 ns", "p99 ns", "p99.9 ns",
+                 "max ns");
+    const workload workloads[] = {load, store, exchange, compare_exchange,
+                                  mixed};
+    std::vector<measurement> results;
+    for (workload w : workloads) {
+        for (int independent = 0; independent < 2; ++independent) {
+            for (int implementation = 0; implementation < 3;
+                 ++implementation) {
+                std::string base = implementation_names[implementation];
+                base += workload_name(w);
+                base += independent ? "/independent" : "/one_pointer";
+                if (filter && base.find(filter) == std::string::npos)
+                    continue;
+                for (unsigned threads : thread_counts) {
+                    const std::string name =
+                            base + "/threads:" + std::to_string(threads);
+                    const measurement m = run_implementation(
+                            implementation, name, w, independent != 0,
+                            threads, seconds);
+                    std::fprintf(table,
+                                 "%-48s %8u %12.2f %9u %9u %9u %9u\n",
+                                 m.name.c_str(), m.threads,
+                                 m.operations_per_second / 1e6, m.p50, m.p99,
+                                 m.p999, m.max);
+                    results.push_back(m);
+                }
+            }
+        }
+    }
+
+    // Locking a weak pointer shared by all threads, only or with half of the
+    // threads storing into it
+    for (int writers = 0; writers < 2; ++writers) {
+        for (int implementation = 0; implementation < 2; ++implementation) {
+            std::string base = implementation ? "atomic_weak_ptr_"
+                                              : "mutex_weak_ptr_";
+            base += writers ? "mixed" : "lock";
+            base += "/one_pointer";
+            if (filter && base.find(filter) == std::string::npos)
+                continue;
+            for (unsigned threads : thread_counts) {
+                const std::string name =
+                        base + "/threads:" + std::to_string(threads);
+                const measurement m =
+                        implementation
+                                ? run_weak<throwing::atomic_weak_ptr<int>>(
+                                          name, writers != 0, threads,
+                                          seconds)
+                                : run_weak<mutex_weak_ptr>(name, writers != 0,
+                                                           threads, seconds);
+                std::fprintf(table, "%-48s %8u %12.2f %9u %9u %9u %9u\n",
+                             m.name.c_str(), m.threads,
+                             m.operations_per_second / 1e6, m.p50, m.p99,
+                             m.p999, m.max);
+                results.push_back(m);
+            }
+        }
+    }
+
+    if (json) {
+        std::FILE *out = json_file ? std::fopen(json_file, "w") : stdout;
+        if (!out) {
+            std::perror(json_file);
+            return EXIT_FAILURE;
+        }
+        write_json(out, results);
+        if (out != stdout)
+            std::fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Minimal microbenchmark harness for throwing_ptr_bench.
+//
+// A benchmark is a function taking a bench::state and running its body
+// state.iterations() times. Benchmarks register themselves with BENCHMARK()
+// and are run by bench/main.cpp, which calibrates the iteration count so that
+// each benchmark runs for a minimum amount of time.
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/** \brief Iteration count and counters for a single benchmark run */
+class state {
+public:
+    explicit state(std::size_t iterations) : iterations_(iterations) {}
+
+    /** \brief Number of times the benchmark body must be run */
+    std::size_t iterations() const { return iterations_; }
+
+private:
+    std::size_t iterations_;
+};
+
+/** \brief Signature of a benchmark function */
+typedef void (*function)(state &);
+
+/** \brief A registered benchmark */
+struct benchmark {
+    const char *name;
+    function fn;
+};
+
+/** \brief All benchmarks registered with BENCHMARK() */
+inline std::vector<benchmark> &registry() {
+    static std::vector<benchmark> benchmarks;
+    return benchmarks;
+}
+
+/** \brief Adds a benchmark to the registry at static initialisation time */
+struct registration {
+    registration(const char *name, function fn) {
+        benchmark b = {name, fn};
+        registry().push_back(b);
+    }
+};
+
+/** \brief Number of heap allocations made by the calling thread
+ *
+ * Maintained by the replacement operator new in bench/main.cpp
+ */
+std::uint64_t thread_allocations();
+
+/** \brief Prevents the compiler from optimising away value */
+template <typename T> inline void do_not_optimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/** \brief Prevents the compiler from caching memory across this point */
+inline void clobber_memory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+} // namespace bench
+
+#define BENCH_CONCAT_IMPL(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_IMPL(a, b)
+
+/** \brief Registers fn as a benchmark named after the function */
+#define BENCHMARK(fn)                                                          \
+    static ::bench::registration BENCH_CONCAT(bench_registration_,            \
+                                              __LINE__)(#fn, fn)
@@ -0,0 +1,323 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Compile time cost of each public header.
+//
+// For each header, a translation unit including only that header is
+// preprocessed and parsed, then a translation unit using the header with a
+// number of distinct pointee types is parsed. The compiler is run with
+// -fsyntax-only, so parsing includes template instantiation but no code
+// generation. Each step is run several times and the fastest run is kept.
+//
+// Reported per header: the lines of preprocessed output, the time to
+// preprocess, the time to parse and the extra time per instantiated pointee
+// type. The first row, which includes nothing, measures the cost of starting
+// the compiler.
+//
+// Usage: throwing_ptr_compile_bench [--runs=N] [--types=N] [--json[=file]]
+//                                   [filter]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if !defined(TSP_CXX) || !defined(TSP_CXX_STANDARD_FLAG) ||                   \
+        !defined(TSP_INCLUDE_DIR)
+#error TSP_CXX, TSP_CXX_STANDARD_FLAG and TSP_INCLUDE_DIR must be defined
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock bench_clock;
+
+/** \brief A header and code using it with pointee<I> */
+struct header_case {
+    const char *header;
+    /** \brief Body of template <int I> int use(), or nullptr when the header
+     * has nothing to instantiate
+     */
+    const char *use;
+    /** \brief Headers needed by use besides the measured one */
+    const char *use_includes;
+};
+
+const header_case cases[] = {
+        {nullptr, nullptr, ""},
+        {"memory",
+         "auto p = std::make_shared<pointee<I>>();\n"
+         "    std::shared_ptr<pointee<I>> q = p;\n"
+         "    std::weak_ptr<pointee<I>> w = q;\n"
+         "    return p->value + (*w.lock()).value;",
+         ""},
+        {"throwing/fwd.hpp", nullptr, ""},
+        {"throwing/shared_ptr_core.hpp",
+         "auto p = throwing::make_shared<pointee<I>>();\n"
+         "    throwing::shared_ptr<pointee<I>> q = p;\n"
+         "    throwing::weak_ptr<pointee<I>> w = q;\n"
+         "    return p->value + (*w.lock()).value;",
+         ""},
+        {"throwing/shared_ptr_atomic.hpp",
+         "static throwing::shared_ptr<pointee<I>> p;\n"
+         "    atomic_store(&p, throwing::make_shared<pointee<I>>());\n"
+         "    return atomic_load(&p)->value;",
+         ""},
+        {"throwing/atomic_shared_ptr.hpp",
+         "static throwing::atomic_shared_ptr<pointee<I>> p;\n"
+         "    p.store(throwing::make_shared<pointee<I>>());\n"
+         "    return p.load()->value;",
+         ""},
+        {"throwing/atomic_weak_ptr.hpp",
+         "static throwing::atomic_weak_ptr<pointee<I>> p;\n"
+         "    auto q = throwing::make_shared<pointee<I>>();\n"
+         "    p.store(q);\n"
+         "    return p.lock()->value;",
+         ""},
+        {"throwing/local_shared_ptr.hpp",
+         "auto p = throwing::make_local_shared<pointee<I>>();\n"
+         "    throwing::local_shared_ptr<pointee<I>> q = p;\n"
+         "    throwing::local_weak_ptr<pointee<I>> w = q;\n"
+         "    return p->value + (*w.lock()).value;",
+         ""},
+        {"throwing/shared_ptr_hash.hpp",
+         "throwing::shared_ptr<pointee<I>> p;\n"
+         "    return static_cast<int>(\n"
+         "            std::hash<throwing::shared_ptr<pointee<I>>>()(p));",
+         ""},
+        {"throwing/shared_ptr_ostream.hpp",
+         "throwing::shared_ptr<pointee<I>> p;\n"
+         "    std::cout << p;\n"
+         "    return 0;",
+         "#include <iostream>\n"},
+        {"throwing/enable_shared_from_this.hpp",
+         "struct node : throwing::enable_shared_from_this<node> {\n"
+         "        pointee<I> value;\n"
+         "    };\n"
+         "    auto p = throwing::make_shared<node>();\n"
+         "    return p->shared_from_this()->value.value;",
+         ""},
+        {"throwing/shared_ptr.hpp",
+         "auto p = throwing::make_shared<pointee<I>>();\n"
+         "    throwing::shared_ptr<pointee<I>> q = p;\n"
+         "    throwing::weak_ptr<pointee<I>> w = q;\n"
+         "    return p->value + (*w.lock()).value;",
+         ""},
+        {"throwing/unique_ptr_core.hpp",
+         "auto p = throwing::make_unique<pointee<I>>();\n"
+         "    throwing::unique_ptr<pointee<I>> q = std::move(p);\n"
+         "    return q->value;",
+         ""},
+        {"throwing/unique_ptr.hpp",
+         "auto p = throwing::make_unique<pointee<I>>();\n"
+         "    throwing::unique_ptr<pointee<I>> q = std::move(p);\n"
+         "    return q->value;",
+         ""},
+};
+
+struct measurement {
+    std::string name;
+    long lines;
+    double preprocess_ms;
+    double parse_ms;
+    /** \brief Negative when the header has nothing to instantiate */
+    double instantiate_us_per_type;
+};
+
+const char source_file[] = "throwing_ptr_compile_bench.cpp";
+const char preprocessed_file[] = "throwing_ptr_compile_bench.ii";
+
+bool write_source(const header_case &c, bool with_use, int types) {
+    std::FILE *out = std::fopen(source_file, "w");
+    if (!out) {
+        std::perror(source_file);
+        return false;
+    }
+    if (c.header)
+        std::fprintf(out, "#include <%s>\n", c.header);
+    if (with_use) {
+        std::fprintf(out,
+                     "%s"
+                     "template <int I> struct pointee { int value; };\n"
+                     "template <int I> int use() {\n    %s\n}\n"
+                     "template <int N> struct uses {\n"
+                     "    static int run() {\n"
+                     "        return use<N - 1>() + uses<N - 1>::run();\n"
+                     "    }\n"
+                     "};\n"
+                     "template <> struct uses<0> {\n"
+                     "    static int run() { return 0; }\n"
+                     "};\n"
+                     "int main() { return uses<%d>::run(); }\n",
+                     c.use_includes, c.use, types);
+    } else {
+        std::fprintf(out, "int main() { return 0; }\n");
+    }
+    std::fclose(out);
+    return true;
+}
+
+/** \brief Runs the compiler with options on the source file and returns the
+ * wall-clock time of the fastest of runs, in milliseconds, or a negative
+ * value if the compiler failed.
+ */
+double time_compiler(const char *options, int runs) {
+    const std::string command = std::string("\"") + TSP_CXX + "\" " +
+                                TSP_CXX_STANDARD_FLAG + " -I\"" +
+                                TSP_INCLUDE_DIR + "\" " + options + " " +
+                                source_file;
+    double best = -1;
+    for (int i = 0; i < runs; ++i) {
+        const auto begin = bench_clock::now();
+        if (std::system(command.c_str()) != 0) {
+            std::fprintf(stderr, "failed: %s\n", command.c_str());
+            return -1;
+        }
+        const double elapsed = std::chrono::duration<double, std::milli>(
+                                       bench_clock::now() - begin)
+                                       .count();
+        if (best < 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+long count_lines(const char *file) {
+    std::FILE *in = std::fopen(file, "r");
+    if (!in)
+        return -1;
+    long lines = 0;
+    for (int c = std::fgetc(in); c != EOF; c = std::fgetc(in)) {
+        if (c == '\n')
+            ++lines;
+    }
+    std::fclose(in);
+    return lines;
+}
+
+bool measure(const header_case &c, int runs, int types, measurement &m) {
+    m.name = c.header ? c.header : "(nothing)";
+    if (!write_source(c, false, types))
+        return false;
+    const std::string preprocess =
+            std::string("-E -P -o ") + preprocessed_file;
+    m.preprocess_ms = time_compiler(preprocess.c_str(), runs);
+    m.lines = count_lines(preprocessed_file);
+    m.parse_ms = time_compiler("-fsyntax-only", runs);
+    if (m.preprocess_ms < 0 || m.parse_ms < 0)
+        return false;
+    m.instantiate_us_per_type = -1;
+    if (c.use) {
+        if (!write_source(c, true, types))
+            return false;
+        const double used_ms = time_compiler("-fsyntax-only", runs);
+        if (used_ms < 0)
+            return false;
+        m.instantiate_us_per_type =
+                std::max(0.0, used_ms - m.parse_ms) * 1000.0 / types;
+    }
+    return true;
+}
+
+void write_json(std::FILE *out, const std::vector<measurement> &results) {
+    std::fprintf(out, "{\n  \"benchmarks\": [");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const measurement &m = results[i];
+        std::fprintf(out, "%s\n    {\n", i ? "," : "");
+        std::fprintf(out, "      \"name\": \"%s\",\n", m.name.c_str());
+        std::fprintf(out, "      \"preprocessed_lines\": %ld,\n", m.lines);
+        std::fprintf(out, "      \"preprocess_ms\": %.2f,\n",
+                     m.preprocess_ms);
+        if (m.instantiate_us_per_type >= 0) {
+            std::fprintf(out, "      \"parse_ms\": %.2f,\n", m.parse_ms);
+            std::fprintf(out, "      \"instantiate_us_per_type\": %.1f\n",
+                         m.instantiate_us_per_type);
+        } else {
+            std::fprintf(out, "      \"parse_ms\": %.2f\n", m.parse_ms);
+        }
+        std::fprintf(out, "    }");
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+void print_usage(const char *program) {
+    std::fprintf(stderr,
+                 "usage: %s [--runs=N] [--types=N] [--json[=file]] "
+                 "[filter]\n",
+                 program);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int runs = 3;
+    int types = 64;
+    const char *filter = nullptr;
+    bool json = false;
+    const char *json_file = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--runs=", 7) == 0) {
+            runs = std::atoi(argv[i] + 7);
+        } else if (std::strncmp(argv[i], "--types=", 8) == 0) {
+            types = std::atoi(argv[i] + 8);
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (std::strncmp(argv[i], "--json=", 7) == 0) {
+            json = true;
+            json_file = argv[i] + 7;
+        } else if (argv[i][0] == '-' || filter) {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        } else {
+            filter = argv[i];
+        }
+    }
+    if (runs <= 0 || types <= 0) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The table goes to stderr when the JSON goes to stdout
+    std::FILE *table = json && !json_file ? stderr : stdout;
+    std::fprintf(table, "%-40s %10s %14s %10s %14s\n", "header", "lines",
+                 "preprocess ms", "parse ms", "us/type");
+    std::vector<measurement> results;
+    int status = 0;
+    for (const header_case &c : cases) {
+        if (filter && c.header && !std::strstr(c.header, filter))
+            continue;
+        measurement m;
+        if (!measure(c, runs, types, m)) {
+            status = EXIT_FAILURE;
+            continue;
+        }
+        if (m.instantiate_us_per_type >= 0) {
+            std::fprintf(table, "%-40s %10ld %14.1f %10.1f %14.1f\n",
+                         m.name.c_str(), m.lines, m.preprocess_ms, m.parse_ms,
+                         m.instantiate_us_per_type);
+        } else {
+            std::fprintf(table, "%-40s %10ld %14.1f %10.1f %14s\n",
+                         m.name.c_str(), m.lines, m.preprocess_ms, m.parse_ms,
+                         "-");
+        }
+        results.push_back(m);
+    }
+    std::remove(source_file);
+    std::remove(preprocessed_file);
+
+    if (json) {
+        std::FILE *out = json_file ? std::fopen(json_file, "w") : stdout;
+        if (!out) {
+            std::perror(json_file);
+            return EXIT_FAILURE;
+        }
+        write_json(out, results);
+        if (out != stdout)
+            std::fclose(out);
+    }
+    return status;
+}
@@ -0,0 +1,69 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Cost of dereferencing non-null pointers, compared with the std smart
+// pointers. The null checks and the call site capture must not add measurable
+// cost on this path.
+
+#include "bench.hpp"
+#include <memory>
+#include <throwing/not_null.hpp>
+#include <throwing/shared_ptr.hpp>
+#include <throwing/unique_ptr.hpp>
+
+namespace {
+
+template <typename Pointer> void deref_loop(bench::state &s, Pointer &ptr) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        bench::do_not_optimize(*ptr);
+    }
+}
+
+void std_shared_ptr_deref(bench::state &s) {
+    auto ptr = std::make_shared<int>(42);
+    deref_loop(s, ptr);
+}
+BENCHMARK(std_shared_ptr_deref);
+
+void shared_ptr_deref(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    deref_loop(s, ptr);
+}
+BENCHMARK(shared_ptr_deref);
+
+void std_unique_ptr_deref(bench::state &s) {
+    std::unique_ptr<int> ptr(new int(42));
+    deref_loop(s, ptr);
+}
+BENCHMARK(std_unique_ptr_deref);
+
+void unique_ptr_deref(bench::state &s) {
+    auto ptr = throwing::make_unique<int>(42);
+    deref_loop(s, ptr);
+}
+BENCHMARK(unique_ptr_deref);
+
+void shared_ptr_try_deref_value(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        bench::do_not_optimize(ptr.try_deref().value());
+    }
+}
+BENCHMARK(shared_ptr_try_deref_value);
+
+void not_null_construct_deref(bench::state &s) {
+    int value = 42;
+    int *raw = &value;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(raw);
+        throwing::not_null<int *> ptr(raw);
+        bench::do_not_optimize(*ptr);
+    }
+}
+BENCHMARK(not_null_construct_deref);
+
+} // namespace
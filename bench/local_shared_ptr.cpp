@@ -0,0 +1,126 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Cost of the reference counting of local_shared_ptr, which is not atomic,
+// compared with std::shared_ptr and throwing::shared_ptr. The *_copy_chain
+// benchmarks pass the pointer by value down a chain of calls, as code that
+// hands shared ownership to helpers does, so each iteration makes several
+// copies and destructions.
+
+#include "bench.hpp"
+#include <memory>
+#include <throwing/local_shared_ptr.hpp>
+#include <throwing/shared_ptr.hpp>
+
+namespace {
+
+#if defined(NDEBUG)
+// The benchmarks measure the release control block, which holds no owner
+// thread: only the vptr and the two counts
+static_assert(sizeof(throwing::detail::local_control_block) ==
+                      sizeof(void *) + 2 * sizeof(long),
+              "local_control_block holds only the vptr and two counts");
+#endif
+
+template <typename Pointer> void copy_loop(bench::state &s, Pointer &ptr) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        Pointer copy(ptr);
+        bench::do_not_optimize(copy);
+    }
+}
+
+const int chain_length = 8;
+
+/** \brief Passes ptr by value to itself depth times, returning the sum of
+ * the pointed-to values
+ */
+template <typename Pointer>
+int pass_down(Pointer ptr, int depth) {
+    bench::do_not_optimize(ptr);
+    if (0 == depth)
+        return *ptr;
+    return *ptr + pass_down(ptr, depth - 1);
+}
+
+template <typename Pointer>
+void copy_chain_loop(bench::state &s, Pointer &ptr) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        bench::do_not_optimize(pass_down(ptr, chain_length));
+    }
+}
+
+void std_shared_ptr_copy_for_local(bench::state &s) {
+    auto ptr = std::make_shared<int>(42);
+    copy_loop(s, ptr);
+}
+BENCHMARK(std_shared_ptr_copy_for_local);
+
+void shared_ptr_copy_for_local(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    copy_loop(s, ptr);
+}
+BENCHMARK(shared_ptr_copy_for_local);
+
+void local_shared_ptr_copy(bench::state &s) {
+    auto ptr = throwing::make_local_shared<int>(42);
+    copy_loop(s, ptr);
+}
+BENCHMARK(local_shared_ptr_copy);
+
+void std_shared_ptr_copy_chain(bench::state &s) {
+    auto ptr = std::make_shared<int>(1);
+    copy_chain_loop(s, ptr);
+}
+BENCHMARK(std_shared_ptr_copy_chain);
+
+void shared_ptr_copy_chain(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(1);
+    copy_chain_loop(s, ptr);
+}
+BENCHMARK(shared_ptr_copy_chain);
+
+void local_shared_ptr_copy_chain(bench::state &s) {
+    auto ptr = throwing::make_local_shared<int>(1);
+    copy_chain_loop(s, ptr);
+}
+BENCHMARK(local_shared_ptr_copy_chain);
+
+void shared_ptr_make_shared_for_local(bench::state &s) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(throwing::make_shared<int>(42));
+    }
+}
+BENCHMARK(shared_ptr_make_shared_for_local);
+
+void local_shared_ptr_make_local_shared(bench::state &s) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(throwing::make_local_shared<int>(42));
+    }
+}
+BENCHMARK(local_shared_ptr_make_local_shared);
+
+void shared_ptr_lock_for_local(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    throwing::weak_ptr<int> weak = ptr;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(weak);
+        bench::do_not_optimize(weak.lock());
+    }
+}
+BENCHMARK(shared_ptr_lock_for_local);
+
+void local_shared_ptr_lock(bench::state &s) {
+    auto ptr = throwing::make_local_shared<int>(42);
+    throwing::local_weak_ptr<int> weak = ptr;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(weak);
+        bench::do_not_optimize(weak.lock());
+    }
+}
+BENCHMARK(local_shared_ptr_lock);
+
+} // namespace
@@ -0,0 +1,232 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "bench.hpp"
+#include "perf_counters.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+thread_local std::uint64_t allocations = 0;
+} // namespace
+
+std::uint64_t bench::thread_allocations() { return allocations; }
+
+// Count allocations so that benchmarks can report heap churn
+void *operator new(std::size_t size) {
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+#define BENCH_STRINGIFY_IMPL(x) #x
+#define BENCH_STRINGIFY(x) BENCH_STRINGIFY_IMPL(x)
+
+namespace {
+
+typedef std::chrono::steady_clock bench_clock;
+
+const double min_seconds = 0.2;
+
+struct measurement {
+    std::size_t iterations;
+    double seconds;
+    std::uint64_t allocations;
+    bench::counter_values counters;
+};
+
+// counters is null when hardware counters are not requested or unavailable
+measurement run_once(const bench::benchmark &b, std::size_t iterations,
+                     bench::perf_counters *counters) {
+    bench::state s(iterations);
+    const std::uint64_t allocations_before = bench::thread_allocations();
+    if (counters)
+        counters->start();
+    const auto start = bench_clock::now();
+    b.fn(s);
+    const auto stop = bench_clock::now();
+    measurement m;
+    if (counters) {
+        m.counters = counters->stop();
+    } else {
+        for (int e = 0; e < bench::counter_event_count; ++e)
+            m.counters.valid[e] = false;
+    }
+    m.iterations = iterations;
+    m.seconds = std::chrono::duration<double>(stop - start).count();
+    m.allocations = bench::thread_allocations() - allocations_before;
+    return m;
+}
+
+measurement run(const bench::benchmark &b, bench::perf_counters *counters) {
+    std::size_t iterations = 1;
+    for (;;) {
+        const measurement m = run_once(b, iterations, counters);
+        if (m.seconds >= min_seconds || iterations >= (std::size_t(1) << 40))
+            return m;
+        // Aim for 1.5 times the minimum time, growing at most tenfold
+        double factor = m.seconds > 0 ? 1.5 * min_seconds / m.seconds : 10;
+        if (factor > 10)
+            factor = 10;
+        if (factor < 2)
+            factor = 2;
+        iterations = static_cast<std::size_t>(iterations * factor);
+    }
+}
+
+void print_usage(const char *program) {
+    std::fprintf(stderr, "usage: %s [--counters] [--json[=file]] [filter]\n",
+                 program);
+}
+
+// Prints the hardware counters of m per operation, or - for the ones that
+// could not be read
+void print_counters(std::FILE *out, const measurement &m) {
+    for (int e = 0; e < bench::counter_event_count; ++e) {
+        if (m.counters.valid[e])
+            std::fprintf(out, " %14.2f", m.counters.value[e] / m.iterations);
+        else
+            std::fprintf(out, " %14s", "-");
+    }
+}
+
+// Writes the results in the layout of Google Benchmark's JSON reporter, so
+// that results can be tracked across releases with the usual tools
+void write_json(std::FILE *out, const std::vector<bench::benchmark> &run,
+                const std::vector<measurement> &results) {
+    char date[32] = "";
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+#if defined(__VERSION__)
+    const char *compiler = __VERSION__;
+#elif defined(_MSC_FULL_VER)
+    const char *compiler = "MSVC " BENCH_STRINGIFY(_MSC_FULL_VER);
+#else
+    const char *compiler = "unknown";
+#endif
+    std::fprintf(out, "{\n  \"context\": {\n");
+    std::fprintf(out, "    \"date\": \"%s\",\n", date);
+    std::fprintf(out, "    \"compiler\": \"%s\",\n", compiler);
+    std::fprintf(out, "    \"cplusplus\": %ld,\n", long(__cplusplus));
+    std::fprintf(out, "    \"library_build_type\": \"%s\"\n",
+#if defined(NDEBUG)
+                 "release"
+#else
+                 "debug"
+#endif
+    );
+    std::fprintf(out, "  },\n  \"benchmarks\": [");
+    for (std::size_t i = 0; i < run.size(); ++i) {
+        const measurement &m = results[i];
+        std::fprintf(out, "%s\n    {\n", i ? "," : "");
+        std::fprintf(out, "      \"name\": \"%s\",\n", run[i].name);
+        std::fprintf(out, "      \"iterations\": %zu,\n", m.iterations);
+        std::fprintf(out, "      \"real_time\": %.4f,\n",
+                     m.seconds * 1e9 / m.iterations);
+        std::fprintf(out, "      \"time_unit\": \"ns\",\n");
+        std::fprintf(out, "      \"allocs_per_op\": %.4f",
+                     double(m.allocations) / m.iterations);
+        for (int e = 0; e < bench::counter_event_count; ++e) {
+            const auto event = static_cast<bench::counter_event>(e);
+            if (m.counters.valid[e])
+                std::fprintf(out, ",\n      \"%s_per_op\": %.4f",
+                             bench::counter_name(event),
+                             m.counters.value[e] / m.iterations);
+        }
+        std::fprintf(out, "\n");
+        std::fprintf(out, "    }");
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *filter = nullptr;
+    bool json = false;
+    const char *json_file = nullptr;
+    bool use_counters = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--counters") == 0) {
+            use_counters = true;
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (std::strncmp(argv[i], "--json=", 7) == 0) {
+            json = true;
+            json_file = argv[i] + 7;
+        } else if (argv[i][0] == '-' || filter) {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        } else {
+            filter = argv[i];
+        }
+    }
+
+    // Fall back to wall-clock time when no hardware counter can be opened,
+    // e.g. when perf_event_open is denied in a container. The counters are
+    // only opened when asked for.
+    std::unique_ptr<bench::perf_counters> hardware_counters;
+    bench::perf_counters *counters = nullptr;
+    if (use_counters) {
+        hardware_counters.reset(new bench::perf_counters());
+        if (hardware_counters->available())
+            counters = hardware_counters.get();
+        else
+            std::fprintf(stderr,
+                         "hardware counters unavailable (%s), reporting "
+                         "wall-clock time only\n",
+                         std::strerror(errno));
+    }
+
+    // The table goes to stderr when the JSON goes to stdout
+    std::FILE *table = json && !json_file ? stderr : stdout;
+    std::fprintf(table, "%-48s %14s %12s %12s", "benchmark", "iterations",
+                 "ns/op", "allocs/op");
+    if (counters) {
+        for (int e = 0; e < bench::counter_event_count; ++e)
+            std::fprintf(table, " %14s",
+                         bench::counter_name(
+                                 static_cast<bench::counter_event>(e)));
+    }
+    std::fprintf(table, "\n");
+    std::vector<bench::benchmark> run_benchmarks;
+    std::vector<measurement> results;
+    for (const auto &b : bench::registry()) {
+        if (filter && !std::strstr(b.name, filter))
+            continue;
+        const measurement m = run(b, counters);
+        std::fprintf(table, "%-48s %14zu %12.2f %12.2f", b.name,
+                     m.iterations, m.seconds * 1e9 / m.iterations,
+                     double(m.allocations) / m.iterations);
+        if (counters)
+            print_counters(table, m);
+        std::fprintf(table, "\n");
+        run_benchmarks.push_back(b);
+        results.push_back(m);
+    }
+
+    if (json) {
+        std::FILE *out = json_file ? std::fopen(json_file, "w") : stdout;
+        if (!out) {
+            std::perror(json_file);
+            return EXIT_FAILURE;
+        }
+        write_json(out, run_benchmarks, results);
+        if (out != stdout)
+            std::fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Cost of throwing and catching the null dereference exceptions
+
+#include "bench.hpp"
+#include <throwing/shared_ptr.hpp>
+#include <throwing/unique_ptr.hpp>
+
+namespace {
+
+void shared_ptr_throw_catch(bench::state &s) {
+    throwing::shared_ptr<int> null_ptr;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        try {
+            bench::do_not_optimize(*null_ptr);
+        } catch (const throwing::base_null_ptr_exception &e) {
+            bench::do_not_optimize(e);
+        }
+    }
+}
+BENCHMARK(shared_ptr_throw_catch);
+
+void unique_ptr_throw_catch(bench::state &s) {
+    throwing::unique_ptr<int> null_ptr;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        try {
+            bench::do_not_optimize(*null_ptr);
+        } catch (const throwing::base_null_ptr_exception &e) {
+            bench::do_not_optimize(e);
+        }
+    }
+}
+BENCHMARK(unique_ptr_throw_catch);
+
+void throw_catch_what(bench::state &s) {
+    throwing::shared_ptr<int> null_ptr;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        try {
+            bench::do_not_optimize(*null_ptr);
+        } catch (const throwing::base_null_ptr_exception &e) {
+            bench::do_not_optimize(e.what());
+        }
+    }
+}
+BENCHMARK(throw_catch_what);
+
+void throw_catch_what_type(bench::state &s) {
+    throwing::shared_ptr<int> null_ptr;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        try {
+            bench::do_not_optimize(*null_ptr);
+        } catch (const throwing::base_null_ptr_exception &e) {
+            bench::do_not_optimize(e.what_type());
+        }
+    }
+}
+BENCHMARK(throw_catch_what_type);
+
+void what_type(bench::state &s) {
+    const throwing::null_ptr_exception<int> e;
+    const throwing::base_null_ptr_exception &base = e;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(base.what_type());
+    }
+}
+BENCHMARK(what_type);
+
+void type_name(bench::state &s) {
+    const throwing::null_ptr_exception<int> e;
+    const throwing::base_null_ptr_exception &base = e;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(base.type_name());
+    }
+}
+BENCHMARK(type_name);
+
+#if defined(THROWING_PTR_BACKTRACE)
+// Cost added to each throw when THROWING_PTR_BACKTRACE is defined, measured
+// by throwing_ptr_backtrace_bench
+void capture_stack_frames(bench::state &s) {
+    const void *frames[THROWING_PTR_BACKTRACE_DEPTH];
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(throwing::detail::capture_stack_frames(
+                frames, THROWING_PTR_BACKTRACE_DEPTH));
+    }
+}
+BENCHMARK(capture_stack_frames);
+#endif
+
+} // namespace
@@ -0,0 +1,186 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Hardware performance counters for throwing_ptr_bench, read through
+// perf_event_open on Linux.
+//
+// Each counter is opened separately, so that the ones the kernel or the CPU
+// supports are reported even when others are not, and counts are scaled when
+// the kernel multiplexes them. Counters are not available on other platforms,
+// or when perf_event_open is denied, as in many containers: benchmarks then
+// report wall-clock time only.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+/** \brief The hardware events counted for each benchmark */
+enum counter_event {
+    cycles,
+    instructions,
+    branch_misses,
+    l1d_read_misses,
+    llc_read_misses,
+    counter_event_count
+};
+
+/** \brief Short name of e, used in tables and JSON */
+inline const char *counter_name(counter_event e) {
+    switch (e) {
+    case cycles:
+        return "cycles";
+    case instructions:
+        return "instructions";
+    case branch_misses:
+        return "branch_misses";
+    case l1d_read_misses:
+        return "l1d_misses";
+    case llc_read_misses:
+        return "llc_misses";
+    case counter_event_count:
+        break;
+    }
+    return "";
+}
+
+/** \brief Values read from the counters, valid[e] is false for the counters
+ * that could not be opened
+ */
+struct counter_values {
+    double value[counter_event_count];
+    bool valid[counter_event_count];
+};
+
+/** \brief Counters of the calling thread, user space only */
+class perf_counters {
+public:
+    perf_counters() {
+        for (int e = 0; e < counter_event_count; ++e)
+            fds[e] = open(static_cast<counter_event>(e));
+    }
+
+    ~perf_counters() {
+#if defined(__linux__)
+        for (int e = 0; e < counter_event_count; ++e) {
+            if (fds[e] >= 0)
+                close(fds[e]);
+        }
+#endif
+    }
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    /** \brief Returns true if at least one counter could be opened */
+    bool available() const {
+        for (int e = 0; e < counter_event_count; ++e) {
+            if (fds[e] >= 0)
+                return true;
+        }
+        return false;
+    }
+
+    /** \brief Resets the counters to zero and starts counting */
+    void start() {
+#if defined(__linux__)
+        for (int e = 0; e < counter_event_count; ++e) {
+            if (fds[e] >= 0) {
+                ioctl(fds[e], PERF_EVENT_IOC_RESET, 0);
+                ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /** \brief Stops counting and returns the counts since start() */
+    counter_values stop() {
+        counter_values result;
+        for (int e = 0; e < counter_event_count; ++e) {
+            result.value[e] = 0;
+            result.valid[e] = false;
+        }
+#if defined(__linux__)
+        for (int e = 0; e < counter_event_count; ++e) {
+            if (fds[e] >= 0)
+                ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (int e = 0; e < counter_event_count; ++e) {
+            // value, time enabled, time running
+            std::uint64_t data[3];
+            if (fds[e] < 0 || read(fds[e], data, sizeof(data)) !=
+                                      static_cast<ssize_t>(sizeof(data)))
+                continue;
+            if (data[2] == 0)
+                continue;
+            // Scale the count if the counter was multiplexed
+            result.value[e] = static_cast<double>(data[0]) *
+                              static_cast<double>(data[1]) /
+                              static_cast<double>(data[2]);
+            result.valid[e] = true;
+        }
+#endif
+        return result;
+    }
+
+private:
+    static int open(counter_event e) {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const std::uint64_t read_miss =
+                (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        switch (e) {
+        case cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case branch_misses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case l1d_read_misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | read_miss;
+            break;
+        case llc_read_misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL | read_miss;
+            break;
+        case counter_event_count:
+            return -1;
+        }
+        const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        return static_cast<int>(fd);
+#else
+        static_cast<void>(e);
+        return -1;
+#endif
+    }
+
+    int fds[counter_event_count];
+};
+
+} // namespace bench
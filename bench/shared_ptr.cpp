@@ -0,0 +1,135 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Cost of the shared_ptr operations other than dereferencing, compared with
+// std::shared_ptr. Each std_* benchmark is followed by its throwing
+// counterpart.
+
+#include "bench.hpp"
+#include <functional>
+#include <memory>
+#include <throwing/shared_ptr.hpp>
+
+namespace {
+
+struct Base {
+    virtual ~Base() {}
+    int value = 42;
+};
+
+struct Derived : Base {};
+
+template <typename Pointer> void copy_loop(bench::state &s, Pointer &ptr) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        Pointer copy(ptr);
+        bench::do_not_optimize(copy);
+    }
+}
+
+template <typename Pointer> void move_loop(bench::state &s, Pointer &ptr) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        Pointer moved(std::move(ptr));
+        bench::do_not_optimize(moved);
+        ptr = std::move(moved);
+    }
+}
+
+template <typename Pointer> void hash_loop(bench::state &s, Pointer &ptr) {
+    const std::hash<Pointer> hash;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        bench::do_not_optimize(hash(ptr));
+    }
+}
+
+void std_shared_ptr_copy(bench::state &s) {
+    auto ptr = std::make_shared<int>(42);
+    copy_loop(s, ptr);
+}
+BENCHMARK(std_shared_ptr_copy);
+
+void shared_ptr_copy(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    copy_loop(s, ptr);
+}
+BENCHMARK(shared_ptr_copy);
+
+void std_shared_ptr_move(bench::state &s) {
+    auto ptr = std::make_shared<int>(42);
+    move_loop(s, ptr);
+}
+BENCHMARK(std_shared_ptr_move);
+
+void shared_ptr_move(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    move_loop(s, ptr);
+}
+BENCHMARK(shared_ptr_move);
+
+void std_shared_ptr_make_shared(bench::state &s) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(std::make_shared<int>(42));
+    }
+}
+BENCHMARK(std_shared_ptr_make_shared);
+
+void shared_ptr_make_shared(bench::state &s) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(throwing::make_shared<int>(42));
+    }
+}
+BENCHMARK(shared_ptr_make_shared);
+
+void std_shared_ptr_static_pointer_cast(bench::state &s) {
+    std::shared_ptr<Base> ptr = std::make_shared<Derived>();
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        bench::do_not_optimize(std::static_pointer_cast<Derived>(ptr));
+    }
+}
+BENCHMARK(std_shared_ptr_static_pointer_cast);
+
+void shared_ptr_static_pointer_cast(bench::state &s) {
+    throwing::shared_ptr<Base> ptr = throwing::make_shared<Derived>();
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        bench::do_not_optimize(throwing::static_pointer_cast<Derived>(ptr));
+    }
+}
+BENCHMARK(shared_ptr_static_pointer_cast);
+
+void std_shared_ptr_dynamic_pointer_cast(bench::state &s) {
+    std::shared_ptr<Base> ptr = std::make_shared<Derived>();
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        bench::do_not_optimize(std::dynamic_pointer_cast<Derived>(ptr));
+    }
+}
+BENCHMARK(std_shared_ptr_dynamic_pointer_cast);
+
+void shared_ptr_dynamic_pointer_cast(bench::state &s) {
+    throwing::shared_ptr<Base> ptr = throwing::make_shared<Derived>();
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        bench::do_not_optimize(throwing::dynamic_pointer_cast<Derived>(ptr));
+    }
+}
+BENCHMARK(shared_ptr_dynamic_pointer_cast);
+
+void std_shared_ptr_hash(bench::state &s) {
+    auto ptr = std::make_shared<int>(42);
+    hash_loop(s, ptr);
+}
+BENCHMARK(std_shared_ptr_hash);
+
+void shared_ptr_hash(bench::state &s) {
+    auto ptr = throwing::make_shared<int>(42);
+    hash_loop(s, ptr);
+}
+BENCHMARK(shared_ptr_hash);
+
+} // namespace
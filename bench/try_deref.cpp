@@ -0,0 +1,58 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Cost of handling expected null pointers without exceptions, to compare with
+// the throw_catch benchmarks
+
+#include "bench.hpp"
+#include <throwing/shared_ptr.hpp>
+#include <throwing/unique_ptr.hpp>
+
+namespace {
+
+void shared_ptr_try_deref_null(bench::state &s) {
+    throwing::shared_ptr<int> null_ptr;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(null_ptr);
+        auto result = null_ptr.try_deref();
+        if (result)
+            bench::do_not_optimize(*result);
+        else
+            bench::do_not_optimize(result.error());
+    }
+}
+BENCHMARK(shared_ptr_try_deref_null);
+
+void shared_ptr_value_or_null(bench::state &s) {
+    throwing::shared_ptr<int> null_ptr;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(null_ptr);
+        bench::do_not_optimize(null_ptr.value_or(0));
+    }
+}
+BENCHMARK(shared_ptr_value_or_null);
+
+void unique_ptr_try_deref_null(bench::state &s) {
+    throwing::unique_ptr<int> null_ptr;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(null_ptr);
+        auto result = null_ptr.try_deref();
+        if (result)
+            bench::do_not_optimize(*result);
+        else
+            bench::do_not_optimize(result.error());
+    }
+}
+BENCHMARK(unique_ptr_try_deref_null);
+
+void weak_ptr_value_or_expired(bench::state &s) {
+    throwing::weak_ptr<int> expired = throwing::make_shared<int>(42);
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(expired.value_or(0));
+    }
+}
+BENCHMARK(weak_ptr_value_or_expired);
+
+} // namespace
@@ -0,0 +1,103 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Cost of the unique_ptr operations other than dereferencing a single object,
+// compared with std::unique_ptr. Each std_* benchmark is followed by its
+// throwing counterpart.
+
+#include "bench.hpp"
+#include <functional>
+#include <memory>
+#include <throwing/unique_ptr.hpp>
+
+namespace {
+
+template <typename Pointer> void move_loop(bench::state &s, Pointer &ptr) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        Pointer moved(std::move(ptr));
+        bench::do_not_optimize(moved);
+        ptr = std::move(moved);
+    }
+}
+
+template <typename Pointer> void hash_loop(bench::state &s, Pointer &ptr) {
+    const std::hash<Pointer> hash;
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        bench::do_not_optimize(hash(ptr));
+    }
+}
+
+template <typename Pointer> void index_loop(bench::state &s, Pointer &ptr) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(ptr);
+        bench::do_not_optimize(ptr[i & 7]);
+    }
+}
+
+void std_unique_ptr_move(bench::state &s) {
+    std::unique_ptr<int> ptr(new int(42));
+    move_loop(s, ptr);
+}
+BENCHMARK(std_unique_ptr_move);
+
+void unique_ptr_move(bench::state &s) {
+    auto ptr = throwing::make_unique<int>(42);
+    move_loop(s, ptr);
+}
+BENCHMARK(unique_ptr_move);
+
+void std_unique_ptr_make_unique(bench::state &s) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(std::unique_ptr<int>(new int(42)));
+    }
+}
+BENCHMARK(std_unique_ptr_make_unique);
+
+void unique_ptr_make_unique(bench::state &s) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(throwing::make_unique<int>(42));
+    }
+}
+BENCHMARK(unique_ptr_make_unique);
+
+void std_unique_ptr_hash(bench::state &s) {
+    std::unique_ptr<int> ptr(new int(42));
+    hash_loop(s, ptr);
+}
+BENCHMARK(std_unique_ptr_hash);
+
+void unique_ptr_hash(bench::state &s) {
+    auto ptr = throwing::make_unique<int>(42);
+    hash_loop(s, ptr);
+}
+BENCHMARK(unique_ptr_hash);
+
+void std_unique_ptr_to_array_index(bench::state &s) {
+    std::unique_ptr<int[]> ptr(new int[8]());
+    index_loop(s, ptr);
+}
+BENCHMARK(std_unique_ptr_to_array_index);
+
+void unique_ptr_to_array_index(bench::state &s) {
+    auto ptr = throwing::make_unique<int[]>(8);
+    index_loop(s, ptr);
+}
+BENCHMARK(unique_ptr_to_array_index);
+
+void std_unique_ptr_to_array_move(bench::state &s) {
+    std::unique_ptr<int[]> ptr(new int[8]());
+    move_loop(s, ptr);
+}
+BENCHMARK(std_unique_ptr_to_array_move);
+
+void unique_ptr_to_array_move(bench::state &s) {
+    auto ptr = throwing::make_unique<int[]>(8);
+    move_loop(s, ptr);
+}
+BENCHMARK(unique_ptr_to_array_move);
+
+} // namespace
@@ -0,0 +1,70 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Cost of the weak_ptr operations, compared with std::weak_ptr. Each std_*
+// benchmark is followed by its throwing counterpart.
+
+#include "bench.hpp"
+#include <memory>
+#include <throwing/shared_ptr.hpp>
+
+namespace {
+
+template <typename Weak> void lock_loop(bench::state &s, Weak &weak) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(weak);
+        bench::do_not_optimize(weak.lock());
+    }
+}
+
+template <typename Weak> void copy_loop(bench::state &s, Weak &weak) {
+    for (std::size_t i = 0; i < s.iterations(); ++i) {
+        bench::do_not_optimize(weak);
+        Weak copy(weak);
+        bench::do_not_optimize(copy);
+    }
+}
+
+void std_weak_ptr_lock(bench::state &s) {
+    auto shared = std::make_shared<int>(42);
+    std::weak_ptr<int> weak(shared);
+    lock_loop(s, weak);
+}
+BENCHMARK(std_weak_ptr_lock);
+
+void weak_ptr_lock(bench::state &s) {
+    auto shared = throwing::make_shared<int>(42);
+    throwing::weak_ptr<int> weak(shared);
+    lock_loop(s, weak);
+}
+BENCHMARK(weak_ptr_lock);
+
+void std_weak_ptr_lock_expired(bench::state &s) {
+    std::weak_ptr<int> weak(std::make_shared<int>(42));
+    lock_loop(s, weak);
+}
+BENCHMARK(std_weak_ptr_lock_expired);
+
+void weak_ptr_lock_expired(bench::state &s) {
+    throwing::weak_ptr<int> weak(throwing::make_shared<int>(42));
+    lock_loop(s, weak);
+}
+BENCHMARK(weak_ptr_lock_expired);
+
+void std_weak_ptr_copy(bench::state &s) {
+    auto shared = std::make_shared<int>(42);
+    std::weak_ptr<int> weak(shared);
+    copy_loop(s, weak);
+}
+BENCHMARK(std_weak_ptr_copy);
+
+void weak_ptr_copy(bench::state &s) {
+    auto shared = throwing::make_shared<int>(42);
+    throwing::weak_ptr<int> weak(shared);
+    copy_loop(s, weak);
+}
+BENCHMARK(weak_ptr_copy);
+
+} // namespace
@@ -0,0 +1,166 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/atomic_shared_ptr.hpp
+ * \brief Lock-free atomic throwing::shared_ptr
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <throwing/fwd.hpp>
+#include <throwing/shared_ptr_core.hpp>
+#include <throwing/private/split_count_atomic.hpp>
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+
+/** \brief Atomic throwing::shared_ptr with lock-free operations
+ *
+ * The interface follows std::atomic<std::shared_ptr<T>>. Unlike the atomic_*
+ * functions, which share the implementation of the std library (a pool of
+ * mutexes in libstdc++ and libc++), loads, stores, exchanges and compare
+ * exchanges are lock-free wherever a 64-bit atomic integer is.
+ *
+ * The held pointer is kept in a heap node, which a load keeps alive with a
+ * count packed next to its address while it copies the pointer out, see
+ * throwing/private/split_count_atomic.hpp. A load costs two atomic operations
+ * on the atomic_shared_ptr and one on the control block; a store allocates a
+ * node, unless the stored pointer is empty. Up to 65535 threads can load from
+ * the same atomic_shared_ptr at the same time on 64-bit targets.
+ *
+ * Two shared_ptr are equivalent, for compare_exchange_* and wait, if they
+ * store the same pointer and share ownership.
+ */
+template <typename T, typename NullPolicy> class atomic_shared_ptr {
+public:
+    /** \brief Type of the held pointer */
+    typedef shared_ptr<T, NullPolicy> value_type;
+
+    /** \brief Constructs an atomic_shared_ptr holding an empty pointer */
+    atomic_shared_ptr() TSP_NOEXCEPT {}
+
+    /** \brief Constructs an atomic_shared_ptr holding an empty pointer */
+    atomic_shared_ptr(std::nullptr_t) TSP_NOEXCEPT {}
+
+    /** \brief Constructs an atomic_shared_ptr holding desired
+     *
+     * \throw std::bad_alloc if the node holding desired cannot be allocated
+     */
+    atomic_shared_ptr(value_type desired)
+            : a(std::move(desired.get_std_shared_ptr())) {}
+
+    atomic_shared_ptr(const atomic_shared_ptr &) = delete;
+    atomic_shared_ptr &operator=(const atomic_shared_ptr &) = delete;
+
+    /** \brief Equivalent to store(desired) */
+    void operator=(value_type desired) { store(std::move(desired)); }
+
+    /** \brief Equivalent to store(nullptr) */
+    void operator=(std::nullptr_t) TSP_NOEXCEPT { store(value_type()); }
+
+    /** \brief Checks whether the operations are lock-free */
+    bool is_lock_free() const TSP_NOEXCEPT { return a.is_lock_free(); }
+
+    /** \brief Atomically replaces the held pointer with desired
+     *
+     * \throw std::bad_alloc if desired is not empty and the node holding it
+     * cannot be allocated, in which case the held pointer is unchanged
+     */
+    void store(value_type desired,
+               std::memory_order order = std::memory_order_seq_cst) {
+        a.store(std::move(desired.get_std_shared_ptr()), order);
+    }
+
+    /** \brief Atomically returns a copy of the held pointer */
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const {
+        return value_type(a.load(order));
+    }
+
+    /** \brief Equivalent to load() */
+    operator value_type() const { return load(); }
+
+    /** \brief Atomically replaces the held pointer with desired and returns
+     * the pointer held before
+     *
+     * \throw std::bad_alloc as store()
+     */
+    value_type exchange(value_type desired,
+                        std::memory_order order = std::memory_order_seq_cst) {
+        return value_type(
+                a.exchange(std::move(desired.get_std_shared_ptr()), order));
+    }
+
+    /** \brief Replaces the held pointer with desired if it is equivalent to
+     * expected, otherwise copies the held pointer into expected.
+     *
+     * Does not fail spuriously.
+     *
+     * \return whether the held pointer was replaced
+     * \throw std::bad_alloc as store()
+     */
+    bool compare_exchange_strong(value_type &expected, value_type desired,
+                                 std::memory_order success,
+                                 std::memory_order failure) {
+        return a.compare_exchange(expected.get_std_shared_ptr(),
+                                  std::move(desired.get_std_shared_ptr()),
+                                  success, failure);
+    }
+
+    /** \brief Equivalent to compare_exchange_strong(expected, desired,
+     * success, failure)
+     */
+    bool compare_exchange_weak(value_type &expected, value_type desired,
+                               std::memory_order success,
+                               std::memory_order failure) {
+        return compare_exchange_strong(expected, std::move(desired), success,
+                                       failure);
+    }
+
+    /** \brief Equivalent to compare_exchange_strong(expected, desired, order,
+     * failure), where failure is order without its release part
+     */
+    bool compare_exchange_strong(
+            value_type &expected, value_type desired,
+            std::memory_order order = std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, std::move(desired), order,
+                                       detail::failure_order(order));
+    }
+
+    /** \brief Equivalent to compare_exchange_strong(expected, desired, order)
+     */
+    bool compare_exchange_weak(
+            value_type &expected, value_type desired,
+            std::memory_order order = std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, std::move(desired), order,
+                                       detail::failure_order(order));
+    }
+
+    /** \brief Blocks until the held pointer is not equivalent to old and
+     * notify_one() or notify_all() is called, or returns at once if it
+     * already differs.
+     *
+     * Uses std::atomic::wait where available (C++20) and yields in a loop
+     * otherwise.
+     */
+    void wait(value_type old,
+              std::memory_order order = std::memory_order_seq_cst) const {
+        a.wait(old.get_std_shared_ptr(), order);
+    }
+
+    /** \brief Unblocks a thread blocked in wait(), if any */
+    void notify_one() TSP_NOEXCEPT { a.notify_one(); }
+
+    /** \brief Unblocks all the threads blocked in wait() */
+    void notify_all() TSP_NOEXCEPT { a.notify_all(); }
+
+private:
+    detail::split_count_atomic<std::shared_ptr<T>> a;
+};
+
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
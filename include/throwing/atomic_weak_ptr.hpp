@@ -0,0 +1,168 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/atomic_weak_ptr.hpp
+ * \brief Lock-free atomic throwing::weak_ptr
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <throwing/fwd.hpp>
+#include <throwing/shared_ptr_core.hpp>
+#include <throwing/private/split_count_atomic.hpp>
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+
+/** \brief Atomic throwing::weak_ptr with lock-free operations
+ *
+ * The interface follows std::atomic<std::weak_ptr<T>>, with the same
+ * implementation and limits as throwing::atomic_shared_ptr, plus lock(),
+ * which locks the held weak pointer without copying it first.
+ *
+ * Two weak_ptr are equivalent, for compare_exchange_* and wait, if they share
+ * ownership. Unlike std::atomic<std::weak_ptr<T>>, the stored pointers are not
+ * compared, as std::weak_ptr does not expose them.
+ */
+template <typename T, typename NullPolicy> class atomic_weak_ptr {
+public:
+    /** \brief Type of the held pointer */
+    typedef weak_ptr<T, NullPolicy> value_type;
+
+    /** \brief Constructs an atomic_weak_ptr holding an empty pointer */
+    atomic_weak_ptr() TSP_NOEXCEPT {}
+
+    /** \brief Constructs an atomic_weak_ptr holding desired
+     *
+     * \throw std::bad_alloc if the node holding desired cannot be allocated
+     */
+    atomic_weak_ptr(value_type desired)
+            : a(std::move(desired.get_std_weak_ptr())) {}
+
+    atomic_weak_ptr(const atomic_weak_ptr &) = delete;
+    atomic_weak_ptr &operator=(const atomic_weak_ptr &) = delete;
+
+    /** \brief Equivalent to store(desired) */
+    void operator=(value_type desired) { store(std::move(desired)); }
+
+    /** \brief Checks whether the operations are lock-free */
+    bool is_lock_free() const TSP_NOEXCEPT { return a.is_lock_free(); }
+
+    /** \brief Atomically replaces the held pointer with desired
+     *
+     * \throw std::bad_alloc if desired is not empty and the node holding it
+     * cannot be allocated, in which case the held pointer is unchanged
+     */
+    void store(value_type desired,
+               std::memory_order order = std::memory_order_seq_cst) {
+        a.store(std::move(desired.get_std_weak_ptr()), order);
+    }
+
+    /** \brief Atomically returns a copy of the held pointer */
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const {
+        return value_type(a.load(order));
+    }
+
+    /** \brief Equivalent to load() */
+    operator value_type() const { return load(); }
+
+    /** \brief Atomically locks the held pointer
+     *
+     * Equivalent to load(order).lock(), without copying the weak pointer
+     * first.
+     *
+     * \return a shared_ptr sharing ownership of the managed object, or an
+     * empty one if the held pointer is empty or expired
+     */
+    shared_ptr<T, NullPolicy>
+    lock(std::memory_order order = std::memory_order_seq_cst) const {
+        return shared_ptr<T, NullPolicy>(
+                a.visit([](const std::weak_ptr<T> &w) { return w.lock(); },
+                        order));
+    }
+
+    /** \brief Atomically replaces the held pointer with desired and returns
+     * the pointer held before
+     *
+     * \throw std::bad_alloc as store()
+     */
+    value_type exchange(value_type desired,
+                        std::memory_order order = std::memory_order_seq_cst) {
+        return value_type(
+                a.exchange(std::move(desired.get_std_weak_ptr()), order));
+    }
+
+    /** \brief Replaces the held pointer with desired if it is equivalent to
+     * expected, otherwise copies the held pointer into expected.
+     *
+     * Does not fail spuriously.
+     *
+     * \return whether the held pointer was replaced
+     * \throw std::bad_alloc as store()
+     */
+    bool compare_exchange_strong(value_type &expected, value_type desired,
+                                 std::memory_order success,
+                                 std::memory_order failure) {
+        return a.compare_exchange(expected.get_std_weak_ptr(),
+                                  std::move(desired.get_std_weak_ptr()),
+                                  success, failure);
+    }
+
+    /** \brief Equivalent to compare_exchange_strong(expected, desired,
+     * success, failure)
+     */
+    bool compare_exchange_weak(value_type &expected, value_type desired,
+                               std::memory_order success,
+                               std::memory_order failure) {
+        return compare_exchange_strong(expected, std::move(desired), success,
+                                       failure);
+    }
+
+    /** \brief Equivalent to compare_exchange_strong(expected, desired, order,
+     * failure), where failure is order without its release part
+     */
+    bool compare_exchange_strong(
+            value_type &expected, value_type desired,
+            std::memory_order order = std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, std::move(desired), order,
+                                       detail::failure_order(order));
+    }
+
+    /** \brief Equivalent to compare_exchange_strong(expected, desired, order)
+     */
+    bool compare_exchange_weak(
+            value_type &expected, value_type desired,
+            std::memory_order order = std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, std::move(desired), order,
+                                       detail::failure_order(order));
+    }
+
+    /** \brief Blocks until the held pointer is not equivalent to old and
+     * notify_one() or notify_all() is called, or returns at once if it
+     * already differs.
+     *
+     * Uses std::atomic::wait where available (C++20) and yields in a loop
+     * otherwise.
+     */
+    void wait(value_type old,
+              std::memory_order order = std::memory_order_seq_cst) const {
+        a.wait(old.get_std_weak_ptr(), order);
+    }
+
+    /** \brief Unblocks a thread blocked in wait(), if any */
+    void notify_one() TSP_NOEXCEPT { a.notify_one(); }
+
+    /** \brief Unblocks all the threads blocked in wait() */
+    void notify_all() TSP_NOEXCEPT { a.notify_all(); }
+
+private:
+    detail::split_count_atomic<std::weak_ptr<T>> a;
+};
+
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
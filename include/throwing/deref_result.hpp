@@ -0,0 +1,132 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/deref_result.hpp
+ * \brief Result of a dereference that does not throw
+ */
+
+#pragma once
+#include <type_traits>
+#include <utility>
+#include <throwing/null_ptr_exception.hpp>
+#include <throwing/private/pointer_address.hpp>
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+
+namespace detail {
+
+/** \brief Return type of value_or(U &&) in the smart pointers.
+ *
+ * Depends on U, so that declaring value_or in a smart pointer to an array or
+ * to an incomplete type is not an error.
+ */
+template <typename T, typename U> struct value_or_result {
+    typedef typename std::remove_cv<T>::type type;
+};
+
+} // namespace detail
+
+/** \brief Result of try_deref(): either a reference to an object of type T or
+ * a null_ptr_exception<T> error.
+ *
+ * The interface follows std::expected<T &, null_ptr_exception<T>>. Checking
+ * and accessing the result never throws, with the exception of value().
+ *
+ * Holder is the type keeping the referenced object reachable: a raw pointer
+ * for shared_ptr and unique_ptr, which keep ownership of the object, and a
+ * std::shared_ptr<T> for weak_ptr, which must keep the object alive for as
+ * long as the result exists.
+ */
+template <typename T, typename Holder = T *> class deref_result {
+public:
+    /** \brief Type of the referenced object */
+    typedef T value_type;
+    /** \brief Type of the error */
+    typedef null_ptr_exception<T> error_type;
+
+    /** \brief Constructs a result holding an error */
+    deref_result() : h() {}
+
+    /** \brief Constructs a result referencing *h, or holding an error if h is
+     * null
+     */
+    explicit deref_result(Holder holder) : h(std::move(holder)) {}
+
+    /** \brief Checks whether the result references an object */
+    bool has_value() const TSP_NOEXCEPT {
+        return nullptr != detail::pointer_address(h);
+    }
+
+    /** \brief Checks whether the result references an object */
+    explicit operator bool() const TSP_NOEXCEPT { return has_value(); }
+
+    /** \brief Returns the referenced object.
+     *
+     * \throw null_ptr_exception<T>, recording the location of the caller, if
+     * the result holds an error
+     */
+    T &value(const source_location &location = source_location::current())
+            const {
+        const auto ptr = detail::pointer_address(h);
+        if (TSP_UNLIKELY(nullptr == ptr))
+            detail::throw_null_ptr_exception<T>(
+                    location.file, location.line, location.function);
+        return *ptr;
+    }
+
+    /** \brief Returns the referenced object.
+     *
+     * The behavior is undefined if the result holds an error.
+     */
+    T &operator*() const TSP_NOEXCEPT { return *detail::pointer_address(h); }
+
+    /** \brief Accesses the referenced object.
+     *
+     * The behavior is undefined if the result holds an error.
+     */
+    T *operator->() const TSP_NOEXCEPT { return detail::pointer_address(h); }
+
+    /** \brief Returns the error.
+     *
+     * The behavior is undefined if the result references an object.
+     */
+    error_type error() const { return error_type(); }
+
+    /** \brief Returns a copy of the referenced object, or default_value
+     * converted to T if the result holds an error.
+     */
+    template <typename U>
+    typename std::remove_cv<T>::type value_or(U &&default_value) const {
+        const auto ptr = detail::pointer_address(h);
+        if (nullptr == ptr)
+            return static_cast<typename std::remove_cv<T>::type>(
+                    std::forward<U>(default_value));
+        return *ptr;
+    }
+
+    /** \brief Returns f(value()) if the result references an object,
+     * otherwise a default constructed result of the same type.
+     *
+     * f must return a deref_result, e.g. by calling try_deref() on a pointer
+     * reachable from the referenced object. A failure at any step of a chain
+     * yields the error of the last step.
+     */
+    template <typename F>
+    auto and_then(F &&f) const -> decltype(f(std::declval<T &>())) {
+        typedef decltype(f(std::declval<T &>())) result_type;
+        const auto ptr = detail::pointer_address(h);
+        if (nullptr == ptr)
+            return result_type();
+        return std::forward<F>(f)(*ptr);
+    }
+
+private:
+    Holder h;
+};
+
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
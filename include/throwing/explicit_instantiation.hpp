@@ -0,0 +1,71 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/explicit_instantiation.hpp
+ * \brief Macros declaring and defining explicit instantiations of the smart
+ * pointers for a pointee type
+ *
+ * Every translation unit that uses throwing::shared_ptr<Widget> instantiates
+ * the same templates, and the linker discards all copies but one. To
+ * instantiate them once, declare the instantiations after the definition of
+ * Widget, typically in its header:
+ *
+ *     #include <throwing/explicit_instantiation.hpp>
+ *
+ *     struct Widget { ... };
+ *     THROWING_PTR_EXTERN_TEMPLATES(Widget)
+ *
+ * and define them in exactly one source file:
+ *
+ *     #include "widget.hpp"
+ *
+ *     THROWING_PTR_INSTANTIATE_TEMPLATES(Widget)
+ *
+ * Both macros must be used at global namespace scope, with a complete object
+ * type that is not an array. They cover shared_ptr<T>, weak_ptr<T>,
+ * unique_ptr<T> and null_ptr_exception<T> with the default deleter and null
+ * policy, and the functions throwing null_ptr_exception<T>. The definition
+ * instantiates every member function, so T must be destructible there.
+ *
+ * Member templates, such as the converting constructors and value_or, and
+ * function templates, such as make_shared and the comparison operators, are
+ * still instantiated where they are used, and so are the implicitly defined
+ * destructors. The compiler may still inline the members defined in the
+ * class; only their out-of-line copies are shared.
+ */
+
+#pragma once
+#include <memory>
+#include <throwing/null_ptr_exception.hpp>
+#include <throwing/shared_ptr.hpp>
+#include <throwing/unique_ptr.hpp>
+
+/** \brief Declares that the templates of the smart pointers to T are
+ * instantiated in another translation unit
+ */
+#define THROWING_PTR_EXTERN_TEMPLATES(T)                                       \
+    extern template class throwing::shared_ptr<T>;                             \
+    extern template class throwing::weak_ptr<T>;                               \
+    extern template class throwing::unique_ptr<T>;                             \
+    extern template class throwing::null_ptr_exception<T>;                     \
+    extern template void throwing::detail::throw_null_ptr_exception<T>();      \
+    extern template void throwing::detail::throw_null_ptr_exception<T>(        \
+            const char *, unsigned, const char *);                             \
+    extern template const char *throwing::detail::type_name<T>();              \
+    extern template const char *throwing::detail::null_ptr_type_message<T>();
+
+/** \brief Instantiates the templates of the smart pointers to T declared by
+ * THROWING_PTR_EXTERN_TEMPLATES(T)
+ */
+#define THROWING_PTR_INSTANTIATE_TEMPLATES(T)                                  \
+    template class throwing::shared_ptr<T>;                                    \
+    template class throwing::weak_ptr<T>;                                      \
+    template class throwing::unique_ptr<T>;                                    \
+    template class throwing::null_ptr_exception<T>;                            \
+    template void throwing::detail::throw_null_ptr_exception<T>();             \
+    template void throwing::detail::throw_null_ptr_exception<T>(               \
+            const char *, unsigned, const char *);                             \
+    template const char *throwing::detail::type_name<T>();                     \
+    template const char *throwing::detail::null_ptr_type_message<T>();
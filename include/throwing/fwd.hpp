@@ -0,0 +1,51 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/fwd.hpp
+ * \brief Forward declarations of the smart pointers, null policies and
+ * exceptions
+ *
+ * Enough to declare functions and members that take or return the smart
+ * pointers by reference, without the cost of their definitions, of
+ * null_ptr_exception and of the std headers they need. The default template
+ * arguments are given here, and only here.
+ *
+ * <memory> is included for std::default_delete, the default deleter of
+ * throwing::unique_ptr, which cannot be declared outside the standard library.
+ */
+
+#pragma once
+#include <memory>
+#include <typeinfo>
+
+namespace throwing {
+
+struct throw_on_null;
+struct terminate_on_null;
+template <void (*Callback)(const std::type_info &)> struct callback_on_null;
+struct unchecked_on_null;
+
+class base_null_ptr_exception;
+template <typename T> class null_ptr_exception;
+
+template <typename T, typename NullPolicy = throw_on_null> class shared_ptr;
+template <typename T, typename NullPolicy = throw_on_null> class weak_ptr;
+template <typename T> class enable_shared_from_this;
+template <typename T, typename NullPolicy = throw_on_null>
+class atomic_shared_ptr;
+template <typename T, typename NullPolicy = throw_on_null>
+class atomic_weak_ptr;
+template <typename T, typename NullPolicy = throw_on_null>
+class local_shared_ptr;
+template <typename T, typename NullPolicy = throw_on_null>
+class local_weak_ptr;
+
+template <typename T, typename Deleter = std::default_delete<T>,
+          typename NullPolicy = throw_on_null>
+class unique_ptr;
+
+template <typename P> class not_null;
+
+} // namespace throwing
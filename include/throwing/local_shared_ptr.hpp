@@ -0,0 +1,722 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/local_shared_ptr.hpp
+ * \brief throwing::local_shared_ptr and throwing::local_weak_ptr, shared
+ * ownership within a single thread
+ */
+
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#if !defined(NDEBUG)
+#include <thread>
+#endif
+#include <type_traits>
+#include <utility>
+#include <throwing/fwd.hpp>
+#include <throwing/deref_result.hpp>
+#include <throwing/null_policy.hpp>
+#include <throwing/null_ptr_exception.hpp>
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+
+namespace detail {
+
+/** \brief Control block of local_shared_ptr and local_weak_ptr, with plain
+ * counts
+ *
+ * Builds where NDEBUG is not defined remember the thread that created it and
+ * assert that every count update happens on that thread. Release builds keep
+ * only the two counts, so NDEBUG must be the same in every translation unit
+ * of a program.
+ */
+class local_control_block {
+public:
+    local_control_block() TSP_NOEXCEPT : uses(1), weaks(1) {}
+
+    local_control_block(const local_control_block &) = delete;
+    local_control_block &operator=(const local_control_block &) = delete;
+
+    void add_use() TSP_NOEXCEPT {
+        check_thread();
+        ++uses;
+    }
+
+    /** \brief Adds a use unless the object was already destroyed */
+    bool add_use_if_alive() TSP_NOEXCEPT {
+        check_thread();
+        if (0 == uses)
+            return false;
+        ++uses;
+        return true;
+    }
+
+    void release_use() TSP_NOEXCEPT {
+        check_thread();
+        if (0 == --uses) {
+            dispose();
+            // The owners together hold one weak count
+            release_weak();
+        }
+    }
+
+    void add_weak() TSP_NOEXCEPT {
+        check_thread();
+        ++weaks;
+    }
+
+    void release_weak() TSP_NOEXCEPT {
+        check_thread();
+        if (0 == --weaks)
+            destroy();
+    }
+
+    long use_count() const TSP_NOEXCEPT { return uses; }
+
+protected:
+    virtual ~local_control_block() {}
+
+private:
+    /** \brief Destroys the managed object */
+    virtual void dispose() TSP_NOEXCEPT = 0;
+    /** \brief Deletes the control block */
+    virtual void destroy() TSP_NOEXCEPT = 0;
+
+    void check_thread() const TSP_NOEXCEPT {
+#if !defined(NDEBUG)
+        assert(owner == std::this_thread::get_id() &&
+               "local_shared_ptr used from a thread other than its creator");
+#endif
+    }
+
+    long uses;
+    long weaks;
+#if !defined(NDEBUG)
+    const std::thread::id owner = std::this_thread::get_id();
+#endif
+};
+
+/** \brief Control block owning a pointer p, deleted with d */
+template <typename Y, typename D>
+class local_pointer_block final : public local_control_block {
+public:
+    local_pointer_block(Y *p, const D &d) : p(p), d(d) {}
+
+private:
+    void dispose() TSP_NOEXCEPT override { d(p); }
+    void destroy() TSP_NOEXCEPT override { delete this; }
+
+    Y *p;
+    D d;
+};
+
+/** \brief Control block holding the managed object, for make_local_shared */
+template <typename T>
+class local_inplace_block final : public local_control_block {
+public:
+    template <typename... Args> explicit local_inplace_block(Args &&... args) {
+        ::new (static_cast<void *>(storage)) T(std::forward<Args>(args)...);
+    }
+
+    T *get() TSP_NOEXCEPT { return reinterpret_cast<T *>(storage); }
+
+private:
+    void dispose() TSP_NOEXCEPT override { get()->~T(); }
+    void destroy() TSP_NOEXCEPT override { delete this; }
+
+    alignas(T) unsigned char storage[sizeof(T)];
+};
+
+} // namespace detail
+
+/*! \class throwing::local_shared_ptr throwing/local_shared_ptr.hpp
+ *  \brief Smart pointer with shared ownership, for objects that are only
+ * used by one thread
+ *
+ * Works as throwing::shared_ptr, with the same null dereference checks, but
+ * counts references with plain integers instead of atomic ones, so copies and
+ * destructions are cheaper. All the local_shared_ptr and local_weak_ptr that
+ * share ownership of an object must be copied, assigned and destroyed by the
+ * thread that created the first one. Builds where NDEBUG is not defined
+ * assert it.
+ *
+ * Pointers to arrays, custom allocators and enable_shared_from_this are not
+ * supported.
+ *
+ * NullPolicy is the null dereference policy, see throwing::shared_ptr.
+ */
+template <typename T, typename NullPolicy> class local_shared_ptr {
+    static_assert(!std::is_array<T>::value,
+                  "local_shared_ptr does not support arrays");
+
+public:
+    /** \brief the type pointed to. */
+    typedef T element_type;
+
+    /** \brief the type of the weak pointer to the same object */
+    typedef local_weak_ptr<T, NullPolicy> weak_type;
+
+    // allow access to p and c for other instantiations
+    template <typename Y, typename OtherPolicy> friend class local_shared_ptr;
+    template <typename Y, typename OtherPolicy> friend class local_weak_ptr;
+    template <typename U, typename... Args>
+    friend local_shared_ptr<U> make_local_shared(Args &&... args);
+
+    /** \brief Constructs a local_shared_ptr with no managed object */
+    TSP_CONSTEXPR local_shared_ptr() TSP_NOEXCEPT : p(nullptr), c(nullptr) {}
+
+    /** \brief Constructs a local_shared_ptr with no managed object */
+    TSP_CONSTEXPR local_shared_ptr(std::nullptr_t) TSP_NOEXCEPT
+            : p(nullptr),
+              c(nullptr) {}
+
+    /** \brief Constructs a local_shared_ptr managing ptr, deleted with delete
+     *
+     * \throw std::bad_alloc if the control block cannot be allocated, in
+     * which case ptr is deleted
+     */
+    template <typename Y>
+    explicit local_shared_ptr(Y *ptr)
+            : p(ptr), c(make_block(ptr, std::default_delete<Y>())) {}
+
+    /** \brief Constructs a local_shared_ptr managing ptr, deleted with d
+     *
+     * \throw std::bad_alloc if the control block cannot be allocated, in
+     * which case d(ptr) is called
+     */
+    template <typename Y, typename Deleter>
+    local_shared_ptr(Y *ptr, Deleter d) : p(ptr), c(make_block(ptr, d)) {}
+
+    /** \brief Takes ownership of the object managed by r, if any
+     *
+     * \throw std::bad_alloc if the control block cannot be allocated, in
+     * which case r keeps ownership of its object
+     */
+    template <typename Y, typename Deleter>
+    local_shared_ptr(std::unique_ptr<Y, Deleter> &&r)
+            : p(r.get()),
+              c(nullptr == r.get() ? nullptr
+                                   : new_block(r.get(), r.get_deleter())) {
+        r.release();
+    }
+
+    /** \brief Aliasing constructor: shares ownership with r, but stores ptr
+     *
+     * Typically used to point to a member of the object managed by r.
+     */
+    template <typename Y, typename OtherPolicy>
+    local_shared_ptr(const local_shared_ptr<Y, OtherPolicy> &r,
+                     element_type *ptr) TSP_NOEXCEPT : p(ptr),
+                                                       c(r.c) {
+        if (c)
+            c->add_use();
+    }
+
+    /** \brief Shares ownership of the object managed by r */
+    local_shared_ptr(const local_shared_ptr &r) TSP_NOEXCEPT : p(r.p), c(r.c) {
+        if (c)
+            c->add_use();
+    }
+
+    /** \brief Shares ownership of the object managed by r
+     *
+     * This overload doesn't participate in the overload resolution unless Y*
+     * is implicitly convertible to T*
+     */
+    template <typename Y, typename OtherPolicy,
+              typename = typename std::enable_if<
+                      std::is_convertible<Y *, T *>::value>::type>
+    local_shared_ptr(const local_shared_ptr<Y, OtherPolicy> &r) TSP_NOEXCEPT
+            : p(r.p),
+              c(r.c) {
+        if (c)
+            c->add_use();
+    }
+
+    /** \brief Moves ownership from r, which becomes empty */
+    local_shared_ptr(local_shared_ptr &&r) TSP_NOEXCEPT : p(r.p), c(r.c) {
+        r.p = nullptr;
+        r.c = nullptr;
+    }
+
+    /** \brief Moves ownership from r, which becomes empty
+     *
+     * This overload doesn't participate in the overload resolution unless Y*
+     * is implicitly convertible to T*
+     */
+    template <typename Y, typename OtherPolicy,
+              typename = typename std::enable_if<
+                      std::is_convertible<Y *, T *>::value>::type>
+    local_shared_ptr(local_shared_ptr<Y, OtherPolicy> &&r) TSP_NOEXCEPT
+            : p(r.p),
+              c(r.c) {
+        r.p = nullptr;
+        r.c = nullptr;
+    }
+
+    /** \brief Releases ownership of the managed object, destroying it if
+     * this was its last owner
+     */
+    ~local_shared_ptr() {
+        if (c)
+            c->release_use();
+    }
+
+    /** \brief Shares ownership of the object managed by r */
+    local_shared_ptr &operator=(const local_shared_ptr &r) TSP_NOEXCEPT {
+        local_shared_ptr(r).swap(*this);
+        return *this;
+    }
+
+    /** \brief Shares ownership of the object managed by r */
+    template <typename Y, typename OtherPolicy>
+    local_shared_ptr &
+    operator=(const local_shared_ptr<Y, OtherPolicy> &r) TSP_NOEXCEPT {
+        local_shared_ptr(r).swap(*this);
+        return *this;
+    }
+
+    /** \brief Moves ownership from r, which becomes empty */
+    local_shared_ptr &operator=(local_shared_ptr &&r) TSP_NOEXCEPT {
+        local_shared_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    /** \brief Moves ownership from r, which becomes empty */
+    template <typename Y, typename OtherPolicy>
+    local_shared_ptr &
+    operator=(local_shared_ptr<Y, OtherPolicy> &&r) TSP_NOEXCEPT {
+        local_shared_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    /** \brief Releases ownership of the managed object, if any */
+    void reset() TSP_NOEXCEPT { local_shared_ptr().swap(*this); }
+
+    /** \brief Replaces the managed object with ptr, deleted with delete */
+    template <typename Y> void reset(Y *ptr) {
+        local_shared_ptr(ptr).swap(*this);
+    }
+
+    /** \brief Replaces the managed object with ptr, deleted with d */
+    template <typename Y, typename Deleter> void reset(Y *ptr, Deleter d) {
+        local_shared_ptr(ptr, d).swap(*this);
+    }
+
+    /** \brief Exchanges the contents of *this and r */
+    void swap(local_shared_ptr &r) TSP_NOEXCEPT {
+        std::swap(p, r.p);
+        std::swap(c, r.c);
+    }
+
+    /** \brief Returns the stored pointer */
+    element_type *get() const TSP_NOEXCEPT { return p; }
+
+    /** \brief Dereferences the stored pointer.
+     *
+     * \throw null_ptr_exception<T> if the pointer is null and NullPolicy is
+     * throw_on_null
+     */
+    T &operator*() const {
+        if (TSP_UNLIKELY(nullptr == p))
+            NullPolicy::template null_dereference<T>();
+        return *p;
+    }
+
+    /** \brief Dereferences the stored pointer.
+     *
+     * \throw null_ptr_exception<T> if the pointer is null and NullPolicy is
+     * throw_on_null
+     */
+    T *operator->() const {
+        if (TSP_UNLIKELY(nullptr == p))
+            NullPolicy::template null_dereference<T>();
+        return p;
+    }
+
+    /** \brief Returns the stored pointer, which must not be null.
+     *
+     * See throwing::shared_ptr::get_nonnull().
+     */
+    element_type *get_nonnull() const TSP_NOEXCEPT {
+        assert(nullptr != p &&
+               "get_nonnull() called on a null local_shared_ptr");
+        TSP_ASSUME(nullptr != p);
+        return p;
+    }
+
+    /** \brief Dereferences the stored pointer, which must not be null.
+     *
+     * Equivalent to *get_nonnull().
+     */
+    T &deref_unchecked() const TSP_NOEXCEPT { return *get_nonnull(); }
+
+    /** \brief Dereferences the stored pointer without throwing.
+     *
+     * \return a deref_result referencing the pointed-to object, or holding a
+     * null_ptr_exception<T> error if the pointer is null
+     */
+    deref_result<T> try_deref() const TSP_NOEXCEPT {
+        return deref_result<T>(p);
+    }
+
+    /** \brief Returns a copy of the pointed-to object, or default_value
+     * converted to T if the pointer is null.
+     */
+    template <typename U>
+    typename detail::value_or_result<T, U>::type
+    value_or(U &&default_value) const {
+        return try_deref().value_or(std::forward<U>(default_value));
+    }
+
+    /** \brief Returns f(*get()) if the pointer is not null, otherwise a
+     * default constructed result, see deref_result::and_then.
+     */
+    template <typename F>
+    auto and_then(F &&f) const -> decltype(f(std::declval<T &>())) {
+        return try_deref().and_then(std::forward<F>(f));
+    }
+
+    /** \brief Returns the number of local_shared_ptr managing the current
+     * object, or 0 if there is none
+     */
+    long use_count() const TSP_NOEXCEPT { return c ? c->use_count() : 0; }
+
+    /** \brief Checks whether the stored pointer is not null */
+    explicit operator bool() const TSP_NOEXCEPT { return nullptr != p; }
+
+    /** \brief Checks whether this pointer precedes other in owner-based (as
+     * opposed to value-based) order
+     */
+    template <typename Y, typename OtherPolicy>
+    bool owner_before(const local_shared_ptr<Y, OtherPolicy> &other) const
+            TSP_NOEXCEPT {
+        return std::less<detail::local_control_block *>()(c, other.c);
+    }
+
+    /** \brief Checks whether this pointer precedes other in owner-based (as
+     * opposed to value-based) order
+     */
+    template <typename Y, typename OtherPolicy>
+    bool owner_before(const local_weak_ptr<Y, OtherPolicy> &other) const
+            TSP_NOEXCEPT {
+        return std::less<detail::local_control_block *>()(c, other.c);
+    }
+
+private:
+    local_shared_ptr(element_type *ptr, detail::local_control_block *block)
+            TSP_NOEXCEPT : p(ptr),
+                           c(block) {}
+
+    /** \brief Returns a new control block for ptr, or calls d(ptr) and
+     * rethrows if it cannot be allocated
+     */
+    template <typename Y, typename Deleter>
+    static detail::local_control_block *make_block(Y *ptr, Deleter d) {
+        // Deletes ptr if the allocation throws
+        std::unique_ptr<Y, Deleter &> guard(ptr, d);
+        detail::local_control_block *block = new_block(ptr, d);
+        guard.release();
+        return block;
+    }
+
+    /** \brief Returns a new control block for ptr, deleted with a copy of d
+     */
+    template <typename Y, typename Deleter>
+    static detail::local_control_block *new_block(Y *ptr, const Deleter &d) {
+        return new detail::local_pointer_block<Y, Deleter>(ptr, d);
+    }
+
+    element_type *p;
+    detail::local_control_block *c;
+};
+
+/*! \class throwing::local_weak_ptr throwing/local_shared_ptr.hpp
+ *  \brief Weak reference to an object managed by local_shared_ptr
+ *
+ * Works as throwing::weak_ptr, under the same single thread restriction as
+ * local_shared_ptr.
+ */
+template <typename T, typename NullPolicy> class local_weak_ptr {
+public:
+    /** \brief the type pointed to. */
+    typedef T element_type;
+
+    template <typename Y, typename OtherPolicy> friend class local_shared_ptr;
+    template <typename Y, typename OtherPolicy> friend class local_weak_ptr;
+
+    /** \brief Constructs an empty local_weak_ptr */
+    TSP_CONSTEXPR local_weak_ptr() TSP_NOEXCEPT : p(nullptr), c(nullptr) {}
+
+    /** \brief Shares the object referenced by r */
+    local_weak_ptr(const local_weak_ptr &r) TSP_NOEXCEPT : p(r.p), c(r.c) {
+        if (c)
+            c->add_weak();
+    }
+
+    /** \brief Shares the object referenced by r
+     *
+     * This overload doesn't participate in the overload resolution unless Y*
+     * is implicitly convertible to T*
+     */
+    template <typename Y, typename OtherPolicy,
+              typename = typename std::enable_if<
+                      std::is_convertible<Y *, T *>::value>::type>
+    local_weak_ptr(const local_weak_ptr<Y, OtherPolicy> &r) TSP_NOEXCEPT
+            : p(r.p),
+              c(r.c) {
+        if (c)
+            c->add_weak();
+    }
+
+    /** \brief References the object managed by r
+     *
+     * This overload doesn't participate in the overload resolution unless Y*
+     * is implicitly convertible to T*
+     */
+    template <typename Y, typename OtherPolicy,
+              typename = typename std::enable_if<
+                      std::is_convertible<Y *, T *>::value>::type>
+    local_weak_ptr(const local_shared_ptr<Y, OtherPolicy> &r) TSP_NOEXCEPT
+            : p(r.p),
+              c(r.c) {
+        if (c)
+            c->add_weak();
+    }
+
+    /** \brief Moves the reference from r, which becomes empty */
+    local_weak_ptr(local_weak_ptr &&r) TSP_NOEXCEPT : p(r.p), c(r.c) {
+        r.p = nullptr;
+        r.c = nullptr;
+    }
+
+    /** \brief Releases the reference, without effect on the object */
+    ~local_weak_ptr() {
+        if (c)
+            c->release_weak();
+    }
+
+    /** \brief References the object referenced by r */
+    local_weak_ptr &operator=(const local_weak_ptr &r) TSP_NOEXCEPT {
+        local_weak_ptr(r).swap(*this);
+        return *this;
+    }
+
+    /** \brief References the object managed by r */
+    template <typename Y, typename OtherPolicy>
+    local_weak_ptr &
+    operator=(const local_shared_ptr<Y, OtherPolicy> &r) TSP_NOEXCEPT {
+        local_weak_ptr(r).swap(*this);
+        return *this;
+    }
+
+    /** \brief Moves the reference from r, which becomes empty */
+    local_weak_ptr &operator=(local_weak_ptr &&r) TSP_NOEXCEPT {
+        local_weak_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    /** \brief Releases the reference, if any */
+    void reset() TSP_NOEXCEPT { local_weak_ptr().swap(*this); }
+
+    /** \brief Exchanges the contents of *this and r */
+    void swap(local_weak_ptr &r) TSP_NOEXCEPT {
+        std::swap(p, r.p);
+        std::swap(c, r.c);
+    }
+
+    /** \brief Returns the number of local_shared_ptr managing the object, or
+     * 0 if there is none
+     */
+    long use_count() const TSP_NOEXCEPT { return c ? c->use_count() : 0; }
+
+    /** \brief Checks whether the referenced object was already destroyed */
+    bool expired() const TSP_NOEXCEPT { return 0 == use_count(); }
+
+    /** \brief Returns a local_shared_ptr sharing ownership of the object, or
+     * an empty one if it was already destroyed
+     */
+    local_shared_ptr<T, NullPolicy> lock() const TSP_NOEXCEPT {
+        if (c && c->add_use_if_alive())
+            return local_shared_ptr<T, NullPolicy>(p, c);
+        return local_shared_ptr<T, NullPolicy>();
+    }
+
+    /** \brief Locks the object and references it without throwing.
+     *
+     * \return a deref_result sharing ownership of the object, or holding a
+     * null_ptr_exception<T> error if the local_weak_ptr is expired or empty
+     */
+    deref_result<T, local_shared_ptr<T, NullPolicy>>
+    try_deref() const TSP_NOEXCEPT {
+        return deref_result<T, local_shared_ptr<T, NullPolicy>>(lock());
+    }
+
+    /** \brief Returns a copy of the object, or default_value converted to T
+     * if the local_weak_ptr is expired or empty.
+     */
+    template <typename U>
+    typename detail::value_or_result<T, U>::type
+    value_or(U &&default_value) const {
+        return try_deref().value_or(std::forward<U>(default_value));
+    }
+
+    /** \brief Returns f(object), with object locked for the duration of the
+     * call, if the local_weak_ptr is not expired, otherwise a default
+     * constructed result, see deref_result::and_then.
+     */
+    template <typename F>
+    auto and_then(F &&f) const -> decltype(f(std::declval<T &>())) {
+        return try_deref().and_then(std::forward<F>(f));
+    }
+
+    /** \brief Checks whether this pointer precedes other in owner-based
+     * order
+     */
+    template <typename Y, typename OtherPolicy>
+    bool owner_before(const local_weak_ptr<Y, OtherPolicy> &other) const
+            TSP_NOEXCEPT {
+        return std::less<detail::local_control_block *>()(c, other.c);
+    }
+
+    /** \brief Checks whether this pointer precedes other in owner-based
+     * order
+     */
+    template <typename Y, typename OtherPolicy>
+    bool owner_before(const local_shared_ptr<Y, OtherPolicy> &other) const
+            TSP_NOEXCEPT {
+        return std::less<detail::local_control_block *>()(c, other.c);
+    }
+
+private:
+    T *p;
+    detail::local_control_block *c;
+};
+
+/** \brief Constructs an object of type T and wraps it in a local_shared_ptr,
+ * with one allocation for the object and the control block
+ */
+template <typename T, typename... Args>
+local_shared_ptr<T> make_local_shared(Args &&... args) {
+    static_assert(!std::is_array<T>::value,
+                  "local_shared_ptr does not support arrays");
+    detail::local_inplace_block<T> *const block =
+            new detail::local_inplace_block<T>(std::forward<Args>(args)...);
+    // Converted to the base so that the private constructor is chosen over
+    // the one taking a deleter
+    return local_shared_ptr<T>(
+            block->get(), static_cast<detail::local_control_block *>(block));
+}
+
+/** \brief Exchanges the contents of lhs and rhs */
+template <typename T, typename NullPolicy>
+void swap(local_shared_ptr<T, NullPolicy> &lhs,
+          local_shared_ptr<T, NullPolicy> &rhs) TSP_NOEXCEPT {
+    lhs.swap(rhs);
+}
+
+/** \brief Exchanges the contents of lhs and rhs */
+template <typename T, typename NullPolicy>
+void swap(local_weak_ptr<T, NullPolicy> &lhs,
+          local_weak_ptr<T, NullPolicy> &rhs) TSP_NOEXCEPT {
+    lhs.swap(rhs);
+}
+
+/** \brief Creates a local_shared_ptr sharing ownership with r, whose stored
+ * pointer is static_cast<T *>(r.get())
+ */
+template <typename T, typename U, typename NullPolicy>
+local_shared_ptr<T, NullPolicy>
+static_pointer_cast(const local_shared_ptr<U, NullPolicy> &r) TSP_NOEXCEPT {
+    return local_shared_ptr<T, NullPolicy>(r, static_cast<T *>(r.get()));
+}
+
+/** \brief Creates a local_shared_ptr sharing ownership with r, whose stored
+ * pointer is dynamic_cast<T *>(r.get()), or an empty one if the cast fails
+ */
+template <typename T, typename U, typename NullPolicy>
+local_shared_ptr<T, NullPolicy>
+dynamic_pointer_cast(const local_shared_ptr<U, NullPolicy> &r) TSP_NOEXCEPT {
+    T *const p = dynamic_cast<T *>(r.get());
+    if (nullptr == p)
+        return local_shared_ptr<T, NullPolicy>();
+    return local_shared_ptr<T, NullPolicy>(r, p);
+}
+
+/** \brief Creates a local_shared_ptr sharing ownership with r, whose stored
+ * pointer is const_cast<T *>(r.get())
+ */
+template <typename T, typename U, typename NullPolicy>
+local_shared_ptr<T, NullPolicy>
+const_pointer_cast(const local_shared_ptr<U, NullPolicy> &r) TSP_NOEXCEPT {
+    return local_shared_ptr<T, NullPolicy>(r, const_cast<T *>(r.get()));
+}
+
+/** \brief Creates a local_shared_ptr sharing ownership with r, whose stored
+ * pointer is reinterpret_cast<T *>(r.get())
+ */
+template <typename T, typename U, typename NullPolicy>
+local_shared_ptr<T, NullPolicy> reinterpret_pointer_cast(
+        const local_shared_ptr<U, NullPolicy> &r) TSP_NOEXCEPT {
+    return local_shared_ptr<T, NullPolicy>(r, reinterpret_cast<T *>(r.get()));
+}
+
+/** \brief Compares the stored pointers of lhs and rhs */
+template <typename T, typename P1, typename U, typename P2>
+bool operator==(const local_shared_ptr<T, P1> &lhs,
+                const local_shared_ptr<U, P2> &rhs) TSP_NOEXCEPT {
+    return lhs.get() == rhs.get();
+}
+
+/** \brief Compares the stored pointers of lhs and rhs */
+template <typename T, typename P1, typename U, typename P2>
+bool operator!=(const local_shared_ptr<T, P1> &lhs,
+                const local_shared_ptr<U, P2> &rhs) TSP_NOEXCEPT {
+    return lhs.get() != rhs.get();
+}
+
+/** \brief Orders the stored pointers of lhs and rhs as std::less */
+template <typename T, typename P1, typename U, typename P2>
+bool operator<(const local_shared_ptr<T, P1> &lhs,
+               const local_shared_ptr<U, P2> &rhs) TSP_NOEXCEPT {
+    return std::less<const volatile void *>()(lhs.get(), rhs.get());
+}
+
+/** \brief Checks whether the stored pointer of lhs is null */
+template <typename T, typename NullPolicy>
+bool operator==(const local_shared_ptr<T, NullPolicy> &lhs,
+                std::nullptr_t) TSP_NOEXCEPT {
+    return !lhs;
+}
+
+/** \brief Checks whether the stored pointer of rhs is null */
+template <typename T, typename NullPolicy>
+bool operator==(std::nullptr_t,
+                const local_shared_ptr<T, NullPolicy> &rhs) TSP_NOEXCEPT {
+    return !rhs;
+}
+
+/** \brief Checks whether the stored pointer of lhs is not null */
+template <typename T, typename NullPolicy>
+bool operator!=(const local_shared_ptr<T, NullPolicy> &lhs,
+                std::nullptr_t) TSP_NOEXCEPT {
+    return static_cast<bool>(lhs);
+}
+
+/** \brief Checks whether the stored pointer of rhs is not null */
+template <typename T, typename NullPolicy>
+bool operator!=(std::nullptr_t,
+                const local_shared_ptr<T, NullPolicy> &rhs) TSP_NOEXCEPT {
+    return static_cast<bool>(rhs);
+}
+
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
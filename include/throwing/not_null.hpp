@@ -0,0 +1,155 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/not_null.hpp
+ * \brief Wrapper for pointers that are known not to be null
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <throwing/null_ptr_exception.hpp>
+#include <throwing/private/pointer_address.hpp>
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+
+/** \brief Wraps a pointer P that is not null.
+ *
+ * P can be a raw pointer, a throwing::shared_ptr or a throwing::unique_ptr
+ * (any type with an element_type, a get() member and comparison with nullptr
+ * will do). The pointer is checked once, upon construction, and
+ * null_ptr_exception<element_type> is thrown if it is null. Dereferencing
+ * never checks again.
+ *
+ * Copying is available when P is copyable. Moving would leave a null pointer
+ * behind, so rvalues are copied instead and a not_null wrapping a
+ * throwing::unique_ptr can be neither copied nor moved.
+ *
+ * not_null is implicitly constructible from anything convertible to P, so
+ * that functions taking a not_null can be called with a plain pointer and move
+ * the null check from their body to the call site.
+ */
+template <typename P> class not_null {
+public:
+    /** \brief Type of the wrapped pointer */
+    typedef P pointer_type;
+    /** \brief Type of the pointed-to object */
+    typedef typename std::pointer_traits<P>::element_type element_type;
+
+    /** \brief Constructs a not_null from u.
+     *
+     * \throw null_ptr_exception<element_type>, recording the location of the
+     * caller, if u is null
+     */
+    template <typename U,
+              typename = typename std::enable_if<
+                      std::is_convertible<U, P>::value &&
+                      !std::is_same<typename std::decay<U>::type,
+                                    not_null>::value>::type>
+    not_null(U &&u,
+             const source_location &location = source_location::current())
+            : p(std::forward<U>(u)) {
+        if (TSP_UNLIKELY(nullptr == p))
+            detail::throw_null_ptr_exception<element_type>(
+                    location.file, location.line, location.function);
+    }
+
+    /** \brief Constructs a not_null from another not_null, without checking
+     */
+    template <typename U,
+              typename = typename std::enable_if<
+                      std::is_convertible<const U &, P>::value>::type>
+    not_null(const not_null<U> &other) : p(other.get()) {}
+
+    not_null(const not_null &other) = default;
+    not_null &operator=(const not_null &other) = default;
+
+    not_null(std::nullptr_t) = delete;
+    not_null &operator=(std::nullptr_t) = delete;
+
+    /** \brief Returns the wrapped pointer */
+    const P &get() const TSP_NOEXCEPT { return p; }
+
+    /** \brief Returns the wrapped pointer */
+    operator const P &() const TSP_NOEXCEPT { return p; }
+
+    /** \brief Dereferences the wrapped pointer, without checking for null */
+    element_type &operator*() const TSP_NOEXCEPT { return *operator->(); }
+
+    /** \brief Dereferences the wrapped pointer, without checking for null */
+    element_type *operator->() const TSP_NOEXCEPT {
+        const auto ptr = detail::pointer_address(p);
+        TSP_ASSUME(nullptr != ptr);
+        return ptr;
+    }
+
+private:
+    P p;
+};
+
+/** \brief Compares the wrapped pointers of two not_null objects */
+template <typename P, typename Q>
+auto operator==(const not_null<P> &lhs, const not_null<Q> &rhs)
+        -> decltype(lhs.get() == rhs.get()) {
+    return lhs.get() == rhs.get();
+}
+
+/** \brief Compares the wrapped pointers of two not_null objects */
+template <typename P, typename Q>
+auto operator!=(const not_null<P> &lhs, const not_null<Q> &rhs)
+        -> decltype(lhs.get() != rhs.get()) {
+    return lhs.get() != rhs.get();
+}
+
+/** \brief Compares the wrapped pointers of two not_null objects */
+template <typename P, typename Q>
+auto operator<(const not_null<P> &lhs, const not_null<Q> &rhs)
+        -> decltype(lhs.get() < rhs.get()) {
+    return lhs.get() < rhs.get();
+}
+
+/** \brief Compares the wrapped pointers of two not_null objects */
+template <typename P, typename Q>
+auto operator>(const not_null<P> &lhs, const not_null<Q> &rhs)
+        -> decltype(lhs.get() > rhs.get()) {
+    return lhs.get() > rhs.get();
+}
+
+/** \brief Compares the wrapped pointers of two not_null objects */
+template <typename P, typename Q>
+auto operator<=(const not_null<P> &lhs, const not_null<Q> &rhs)
+        -> decltype(lhs.get() <= rhs.get()) {
+    return lhs.get() <= rhs.get();
+}
+
+/** \brief Compares the wrapped pointers of two not_null objects */
+template <typename P, typename Q>
+auto operator>=(const not_null<P> &lhs, const not_null<Q> &rhs)
+        -> decltype(lhs.get() >= rhs.get()) {
+    return lhs.get() >= rhs.get();
+}
+
+} // namespace throwing
+
+namespace std {
+
+/** \brief Template specialization of std::hash for throwing::not_null<P>
+ *
+ * For a given throwing::not_null<P> p, this specialization ensures that
+ * std::hash<throwing::not_null<P>>()(p) == std::hash<P>()(p.get())
+ */
+template <typename P> struct hash<throwing::not_null<P>> {
+    size_t operator()(const throwing::not_null<P> &x) const {
+        return std::hash<P>()(x.get());
+    }
+};
+
+} // namespace std
+
+#include <throwing/private/clear_compiler_checks.hpp>
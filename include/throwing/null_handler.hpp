@@ -0,0 +1,72 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/null_handler.hpp
+ * \brief Process-wide handler for null dereferences in builds without
+ * exception support
+ *
+ * When exceptions are disabled (e.g. with -fno-exceptions), the default
+ * throw_on_null policy cannot throw null_ptr_exception<T>. The dereference
+ * operators call the installed null handler instead, with the type of the
+ * pointed object. The handler must not return: if it does, std::abort() is
+ * called.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <typeinfo>
+#include <throwing/private/type_name.hpp>
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+
+/** \brief Type of the function called upon dereferencing a null pointer when
+ * exceptions are disabled.
+ *
+ * The argument is the type of the pointed object. The function must not
+ * return to its caller.
+ */
+typedef void (*null_handler)(const std::type_info &);
+
+namespace detail {
+
+/** \brief Writes a message naming the demangled type to stderr, then aborts
+ */
+TSP_NORETURN inline void default_null_handler(const std::type_info &type) {
+    std::fprintf(stderr, "throwing_ptr: Dereferenced nullptr of type %s\n",
+                 demangle(type.name()).c_str());
+    std::abort();
+}
+
+/** \brief Storage for the installed handler, shared by all translation units
+ */
+inline std::atomic<null_handler> &null_handler_storage() {
+    static std::atomic<null_handler> handler(&default_null_handler);
+    return handler;
+}
+
+} // namespace detail
+
+/** \brief Installs h as the null handler and returns the previous one.
+ *
+ * Passing a null pointer reinstalls the default handler, which logs the type
+ * to stderr and calls std::abort().
+ */
+inline null_handler set_null_handler(null_handler h) TSP_NOEXCEPT {
+    return detail::null_handler_storage().exchange(
+            h ? h : &detail::default_null_handler);
+}
+
+/** \brief Returns the currently installed null handler.
+ */
+inline null_handler get_null_handler() TSP_NOEXCEPT {
+    return detail::null_handler_storage().load();
+}
+
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
@@ -0,0 +1,74 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/null_policy.hpp
+ * \brief Policies selecting the reaction to a null pointer dereference
+ *
+ * A null policy is a type with a static member function template
+ * null_dereference<T>(), which throwing::shared_ptr, throwing::weak_ptr and
+ * throwing::unique_ptr call when their operator*, operator-> or operator[] is
+ * used on a null pointer of type T. If null_dereference<T>() returns, the
+ * dereference proceeds and the behavior is undefined.
+ */
+
+#pragma once
+#include <cassert>
+#include <exception>
+#include <typeinfo>
+#include <throwing/null_ptr_exception.hpp>
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+
+/** \brief Throws null_ptr_exception<T> upon dereferencing a null pointer.
+ *
+ * This is the default policy. When exceptions are disabled, the null handler
+ * installed with set_null_handler is called instead.
+ */
+struct throw_on_null {
+    /** \brief Throws null_ptr_exception<T> */
+    template <typename T> TSP_NORETURN static void null_dereference() {
+        detail::throw_null_ptr_exception<T>();
+    }
+};
+
+/** \brief Calls std::terminate upon dereferencing a null pointer.
+ */
+struct terminate_on_null {
+    /** \brief Calls std::terminate() */
+    template <typename T> TSP_NORETURN static void null_dereference() {
+        std::terminate();
+    }
+};
+
+/** \brief Calls Callback upon dereferencing a null pointer.
+ *
+ * Callback receives the type of the pointed object. It may throw an exception
+ * of its choice; if it returns, std::terminate is called.
+ */
+template <void (*Callback)(const std::type_info &)> struct callback_on_null {
+    /** \brief Calls Callback(typeid(T)), then std::terminate() */
+    template <typename T> TSP_NORETURN static void null_dereference() {
+        Callback(typeid(T));
+        std::terminate();
+    }
+};
+
+/** \brief Does not check for null pointers in release builds.
+ *
+ * Dereferencing a null pointer is undefined behavior, as it is for the std
+ * smart pointers, and the null test is removed by the optimizer. Builds where
+ * NDEBUG is not defined keep the check as an assertion.
+ */
+struct unchecked_on_null {
+    /** \brief Asserts when NDEBUG is not defined, otherwise does nothing */
+    template <typename T> static void null_dereference() {
+        assert(false && "null pointer dereference");
+    }
+};
+
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
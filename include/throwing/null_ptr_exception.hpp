@@ -8,22 +8,216 @@
  */
 
 #pragma once
+#include <cstddef>
 #include <exception>
+#include <stdexcept>
 #include <string>
 #include <typeinfo>
+#include <throwing/private/type_name.hpp>
+#if defined(THROWING_PTR_TELEMETRY)
+#include <throwing/telemetry.hpp>
+#endif
+#include <throwing/private/compiler_checks.hpp>
+#if TSP_STACK_TRACE
+// The unwinder and <execinfo.h> are only needed when THROWING_PTR_BACKTRACE
+// requests stack traces
+#include <throwing/private/stack_trace.hpp>
+#include <throwing/private/compiler_checks.hpp>
+#endif
+#if !TSP_EXCEPTIONS
+// The null handler is only called when exceptions are disabled, so other
+// builds do not include its storage and <atomic>
+#include <throwing/null_handler.hpp>
+#include <throwing/private/compiler_checks.hpp>
+#endif
 
 namespace throwing {
 
+/** \brief Location in the source code of a dereference.
+ *
+ * current() returns the location of its caller when used as a default
+ * argument, if the compiler supports it, and an empty location otherwise.
+ */
+struct source_location {
+    /** \brief Name of the source file, empty if unknown */
+    const char *file;
+    /** \brief Line in the source file, 0 if unknown */
+    unsigned line;
+    /** \brief Name of the enclosing function, empty if unknown */
+    const char *function;
+
+    /** \brief Constructs an empty location */
+    TSP_CONSTEXPR source_location() TSP_NOEXCEPT
+            : file(""), line(0), function("") {}
+
+    /** \brief Constructs a location */
+    TSP_CONSTEXPR source_location(const char *file_name, unsigned line_number,
+                                  const char *function_name) TSP_NOEXCEPT
+            : file(file_name), line(line_number), function(function_name) {}
+
+#if TSP_SOURCE_LOCATION
+    /** \brief Returns the location of the caller */
+    static TSP_CONSTEXPR source_location
+    current(const char *file_name = __builtin_FILE(),
+            unsigned line_number = __builtin_LINE(),
+            const char *function_name = __builtin_FUNCTION()) TSP_NOEXCEPT {
+        return source_location(file_name, line_number, function_name);
+    }
+#else
+    /** \brief Returns an empty location */
+    static TSP_CONSTEXPR source_location current() TSP_NOEXCEPT {
+        return source_location();
+    }
+#endif
+};
+
 /** \brief Base class thrown upon dereferencing a null shared_ptr.
  *
  * Use to catch all such errors
+ *
+ * Constructing the exception does not allocate: the message is shared with a
+ * single std::logic_error created on first use, whose reference counted string
+ * is copied rather than duplicated.
+ *
+ * The exception records where the dereference happened. Named functions
+ * taking a source_location, such as deref_result::value() and the not_null
+ * constructor, record the file, line and function of their caller. The
+ * dereference operators cannot take default arguments and record the address
+ * of the code that called them instead, see address().
+ *
+ * Defining THROWING_PTR_BACKTRACE in every translation unit of the program
+ * makes the exceptions thrown by the smart pointers also record the return
+ * addresses of up to THROWING_PTR_BACKTRACE_DEPTH frames of the stack, in a
+ * buffer inside the exception. Recording neither allocates nor resolves
+ * symbols, which is left to stack_trace(). Stack traces are available with
+ * GCC and clang on platforms providing <unwind.h> and <execinfo.h>, such as
+ * Linux and macOS.
  */
 class base_null_ptr_exception : public std::logic_error {
 public:
-    base_null_ptr_exception() : std::logic_error("Dereference of nullptr") {}
-    virtual std::string what_type() const { return ""; }
+    base_null_ptr_exception()
+            : std::logic_error(prototype()), loc(), return_address(nullptr) {
+#if TSP_STACK_TRACE
+        frame_count = 0;
+#endif
+    }
+
+    /** \brief Constructs an exception recording the location of the
+     * dereference and the address of the code that performed it.
+     *
+     * If THROWING_PTR_BACKTRACE is defined, also records the stack, starting
+     * from the frame that address belongs to when it can be found.
+     */
+    base_null_ptr_exception(const source_location &location,
+                            const void *address)
+            : std::logic_error(prototype()), loc(location),
+              return_address(address) {
+#if TSP_STACK_TRACE
+        frame_count = detail::capture_stack_frames(
+                frames, THROWING_PTR_BACKTRACE_DEPTH, address);
+#endif
+    }
+
+    /** \brief Returns a message describing the type of the null pointer.
+     *
+     * The message is built once per type and cached for the lifetime of the
+     * program.
+     */
+    virtual const char *what_type() const { return ""; }
+
+    /** \brief Returns the human readable name of the type of the null
+     * pointer.
+     *
+     * The name is demangled once per type and cached for the lifetime of the
+     * program.
+     */
+    virtual const char *type_name() const { return ""; }
+
+    /** \brief Returns the source file of the dereference, or an empty string
+     * if unknown
+     */
+    const char *file() const TSP_NOEXCEPT { return loc.file; }
+
+    /** \brief Returns the source line of the dereference, or 0 if unknown
+     */
+    unsigned line() const TSP_NOEXCEPT { return loc.line; }
+
+    /** \brief Returns the function performing the dereference, or an empty
+     * string if unknown
+     */
+    const char *function() const TSP_NOEXCEPT { return loc.function; }
+
+    /** \brief Returns an address within the code that performed the
+     * dereference, or nullptr if unknown.
+     *
+     * It can be resolved to a source line with tools such as addr2line.
+     */
+    const void *address() const TSP_NOEXCEPT { return return_address; }
+
+    /** \brief Returns the number of return addresses recorded, 0 unless
+     * THROWING_PTR_BACKTRACE is defined
+     */
+    std::size_t stack_size() const TSP_NOEXCEPT {
+#if TSP_STACK_TRACE
+        return frame_count;
+#else
+        return 0;
+#endif
+    }
+
+    /** \brief Returns the stack_size() return addresses recorded, innermost
+     * first
+     */
+    const void *const *stack_frames() const TSP_NOEXCEPT {
+#if TSP_STACK_TRACE
+        return frames;
+#else
+        return nullptr;
+#endif
+    }
+
+    /** \brief Returns the recorded stack, one frame per line, or an empty
+     * string if none was recorded.
+     *
+     * Symbols are resolved upon each call, from the dynamic symbol table:
+     * link with -rdynamic to see the names of the functions of the program.
+     */
+    std::string stack_trace() const {
+#if TSP_STACK_TRACE
+        return detail::symbolize_stack_frames(frames, frame_count);
+#else
+        return std::string();
+#endif
+    }
+
+private:
+    static const std::logic_error &prototype() {
+        static const std::logic_error prototype("Dereference of nullptr");
+        return prototype;
+    }
+
+    source_location loc;
+    const void *return_address;
+#if TSP_STACK_TRACE
+    const void *frames[THROWING_PTR_BACKTRACE_DEPTH];
+    std::size_t frame_count;
+#endif
 };
 
+namespace detail {
+
+/** \brief Message returned by null_ptr_exception<T>::what_type()
+ *
+ * Built on first use and cached, so that subsequent calls do not allocate.
+ */
+template <typename T> const char *null_ptr_type_message() {
+    static const std::string message =
+            std::string("Dereferenced nullptr of type ") + type_name<T>();
+    return message.c_str();
+}
+
+} // namespace detail
+
 /** \brief Concrete class thrown upon dereferencing a null shared_ptr.
  *
  * Use to catch dereferencing of specific types
@@ -31,11 +225,83 @@ public:
 template <typename T>
 class null_ptr_exception : public base_null_ptr_exception {
 public:
-    virtual std::string what_type() const {
-        std::string result("Dereferenced nullptr of type ");
-        result.append(typeid(T).name());
-        return result;
+    null_ptr_exception() {}
+
+    /** \brief Constructs an exception recording the location of the
+     * dereference and the address of the code that performed it.
+     */
+    null_ptr_exception(const source_location &location, const void *address)
+            : base_null_ptr_exception(location, address) {}
+
+    virtual const char *what_type() const {
+        return detail::null_ptr_type_message<T>();
     }
+
+    virtual const char *type_name() const { return detail::type_name<T>(); }
 };
 
+namespace detail {
+
+/** \brief Throws null_ptr_exception<T>
+ *
+ * Called by the dereference operators when the stored pointer is null. It is
+ * never inlined and is placed in the cold text section, so that each checked
+ * dereference compiles to a test and a branch, with the exception setup code
+ * emitted once per type. The exception records the return address, which
+ * lies in the function where the operator was inlined.
+ *
+ * When exceptions are disabled, calls the installed null handler instead and
+ * aborts if it returns. Either way, the dereference is counted if
+ * THROWING_PTR_TELEMETRY is defined, see throwing/telemetry.hpp, and fires the
+ * throwing_ptr:null_dereference USDT probe if THROWING_PTR_USDT is defined.
+ * The probe arguments are the mangled type name, the return address, the
+ * file name and the line, the last two being null and 0 when unknown.
+ */
+template <typename T>
+TSP_NORETURN TSP_NOINLINE TSP_COLD void throw_null_ptr_exception() {
+    TSP_PROBE4(null_dereference, typeid(T).name(), TSP_RETURN_ADDRESS(),
+               static_cast<const char *>(nullptr), 0u);
+#if defined(THROWING_PTR_TELEMETRY)
+    count_null_dereference<T>();
+#endif
+#if TSP_EXCEPTIONS
+    throw null_ptr_exception<T>(source_location(), TSP_RETURN_ADDRESS());
+#else
+    get_null_handler()(typeid(T));
+    std::abort();
+#endif
+}
+
+/** \brief Throws null_ptr_exception<T> recording a source location
+ *
+ * As throw_null_ptr_exception<T>(), for callers that received the location of
+ * the dereference as a default argument. The location is passed as separate
+ * scalars, which the compiler materializes on the cold path only, so the
+ * non-null path does not pay for it.
+ */
+template <typename T>
+TSP_NORETURN TSP_NOINLINE TSP_COLD void
+throw_null_ptr_exception(const char *file, unsigned line,
+                         const char *function) {
+    TSP_PROBE4(null_dereference, typeid(T).name(), TSP_RETURN_ADDRESS(), file,
+               line);
+#if defined(THROWING_PTR_TELEMETRY)
+    count_null_dereference<T>();
+#endif
+#if TSP_EXCEPTIONS
+    throw null_ptr_exception<T>(source_location(file, line, function),
+                                TSP_RETURN_ADDRESS());
+#else
+    static_cast<void>(file);
+    static_cast<void>(line);
+    static_cast<void>(function);
+    get_null_handler()(typeid(T));
+    std::abort();
+#endif
+}
+
+} // namespace detail
+
 } // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
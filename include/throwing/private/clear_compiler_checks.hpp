@@ -13,3 +13,17 @@
 #undef TSP_CONSTEXPR
 #undef TSP_NOEXCEPT
 #undef TSP_ARRAY_SUPPORT
+#undef TSP_NORETURN
+#undef TSP_NOINLINE
+#undef TSP_COLD
+#undef TSP_LIKELY
+#undef TSP_UNLIKELY
+#undef TSP_ASSUME
+#undef TSP_SOURCE_LOCATION
+#undef TSP_RETURN_ADDRESS
+#undef TSP_EXCEPTIONS
+#undef TSP_PROBE2
+#undef TSP_PROBE3
+#undef TSP_PROBE4
+#undef TSP_STACK_TRACE_SUPPORT
+#undef TSP_STACK_TRACE
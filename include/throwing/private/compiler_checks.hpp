@@ -71,3 +71,113 @@
 #define TSP_NOEXCEPT
 #define TSP_ARRAY_SUPPORT false
 #endif
+
+// Code generation hints for the null check in the dereference operators
+#if defined(__GNUC__) || defined(__clang__)
+#define TSP_NORETURN [[noreturn]]
+#define TSP_NOINLINE __attribute__((noinline))
+#define TSP_COLD __attribute__((cold))
+#define TSP_LIKELY(x) __builtin_expect(!!(x), 1)
+#define TSP_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#elif defined(_MSC_VER)
+#define TSP_NORETURN __declspec(noreturn)
+#define TSP_NOINLINE __declspec(noinline)
+#define TSP_COLD
+#define TSP_LIKELY(x) (x)
+#define TSP_UNLIKELY(x) (x)
+#else
+#define TSP_NORETURN
+#define TSP_NOINLINE
+#define TSP_COLD
+#define TSP_LIKELY(x) (x)
+#define TSP_UNLIKELY(x) (x)
+#endif
+
+// Tells the optimizer that x holds, used by the unchecked accessors. x must
+// not have side effects.
+#if defined(__clang__)
+#define TSP_ASSUME(x) __builtin_assume(x)
+#elif defined(__GNUC__)
+#define TSP_ASSUME(x)                                                          \
+    do {                                                                       \
+        if (!(x))                                                              \
+            __builtin_unreachable();                                           \
+    } while (false)
+#elif defined(_MSC_VER)
+#define TSP_ASSUME(x) __assume(x)
+#else
+#define TSP_ASSUME(x) static_cast<void>(0)
+#endif
+
+// Call site capture for null_ptr_exception. TSP_SOURCE_LOCATION is 1 when
+// __builtin_FILE, __builtin_LINE and __builtin_FUNCTION can be used as
+// default arguments.
+#if defined(__clang__)
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_FILE) && __has_builtin(__builtin_LINE) &&         \
+        __has_builtin(__builtin_FUNCTION)
+#define TSP_SOURCE_LOCATION 1
+#endif
+#endif
+#define TSP_RETURN_ADDRESS() __builtin_return_address(0)
+#elif defined(__GNUC__)
+#define TSP_SOURCE_LOCATION 1
+#define TSP_RETURN_ADDRESS() __builtin_return_address(0)
+#elif defined(_MSC_VER)
+#if _MSC_VER >= 1926
+#define TSP_SOURCE_LOCATION 1
+#endif
+#include <intrin.h>
+#define TSP_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define TSP_RETURN_ADDRESS() nullptr
+#endif
+#if !defined(TSP_SOURCE_LOCATION)
+#define TSP_SOURCE_LOCATION 0
+#endif
+
+// Builds without exception support, such as -fno-exceptions or MSVC without
+// /EHsc, report null dereferences through the installable null handler
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define TSP_EXCEPTIONS 1
+#else
+#define TSP_EXCEPTIONS 0
+#endif
+
+// USDT probes for perf, bpftrace and SystemTap, enabled by defining
+// THROWING_PTR_USDT when <sys/sdt.h> is available. A probe compiles to a nop
+// and an ELF note, so its arguments must be cheap to compute: they are
+// evaluated whether or not a tracer is attached.
+#if defined(THROWING_PTR_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define TSP_PROBE2(name, a1, a2) DTRACE_PROBE2(throwing_ptr, name, a1, a2)
+#define TSP_PROBE3(name, a1, a2, a3)                                           \
+    DTRACE_PROBE3(throwing_ptr, name, a1, a2, a3)
+#define TSP_PROBE4(name, a1, a2, a3, a4)                                       \
+    DTRACE_PROBE4(throwing_ptr, name, a1, a2, a3, a4)
+#endif
+#endif
+#if !defined(TSP_PROBE2)
+#define TSP_PROBE2(name, a1, a2) static_cast<void>(0)
+#define TSP_PROBE3(name, a1, a2, a3) static_cast<void>(0)
+#define TSP_PROBE4(name, a1, a2, a3, a4) static_cast<void>(0)
+#endif
+
+// Stack capture through the unwinder of the Itanium C++ ABI and symbolization
+// through <execinfo.h>. TSP_STACK_TRACE_SUPPORT is 1 when both are available,
+// TSP_STACK_TRACE is 1 when null_ptr_exception records stack traces, which
+// THROWING_PTR_BACKTRACE requests.
+#if defined(__GNUC__) && defined(__has_include)
+#if __has_include(<unwind.h>) && __has_include(<execinfo.h>)
+#define TSP_STACK_TRACE_SUPPORT 1
+#endif
+#endif
+#if !defined(TSP_STACK_TRACE_SUPPORT)
+#define TSP_STACK_TRACE_SUPPORT 0
+#endif
+#if defined(THROWING_PTR_BACKTRACE) && TSP_STACK_TRACE_SUPPORT
+#define TSP_STACK_TRACE 1
+#else
+#define TSP_STACK_TRACE 0
+#endif
@@ -0,0 +1,32 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/private/pointer_address.hpp
+ * \brief Implementation details
+ * This header file must not be included directly
+ * and definitions herein may change without notice
+ */
+
+#pragma once
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+namespace detail {
+
+/** \brief Returns the raw pointer held by a raw or smart pointer
+ */
+template <typename T> T *pointer_address(T *p) TSP_NOEXCEPT { return p; }
+
+/** \brief Returns the raw pointer held by a raw or smart pointer
+ */
+template <typename P>
+auto pointer_address(const P &p) TSP_NOEXCEPT -> decltype(p.get()) {
+    return p.get();
+}
+
+} // namespace detail
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
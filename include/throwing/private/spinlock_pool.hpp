@@ -0,0 +1,130 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/private/spinlock_pool.hpp
+ * \brief Implementation details
+ * This header file must not be included directly
+ * and definitions herein may change without notice
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <throwing/private/compiler_checks.hpp>
+
+/** \brief Number of locks shared by the atomic_* functions when
+ * THROWING_PTR_ATOMIC_SPINLOCK is defined; must be a power of two
+ */
+#if !defined(THROWING_PTR_ATOMIC_STRIPES)
+#define THROWING_PTR_ATOMIC_STRIPES 128
+#endif
+
+namespace throwing {
+namespace detail {
+
+static_assert(THROWING_PTR_ATOMIC_STRIPES > 0 &&
+                      (THROWING_PTR_ATOMIC_STRIPES &
+                       (THROWING_PTR_ATOMIC_STRIPES - 1)) == 0,
+              "THROWING_PTR_ATOMIC_STRIPES must be a power of two");
+
+/** \brief Lock that spins for a short while, then sleeps
+ *
+ * Sleeping uses std::atomic::wait where available (C++20), which is a futex
+ * on Linux, and yields in a loop otherwise.
+ */
+class spinlock {
+public:
+    TSP_CONSTEXPR spinlock() TSP_NOEXCEPT : state(unlocked) {}
+
+    spinlock(const spinlock &) = delete;
+    spinlock &operator=(const spinlock &) = delete;
+
+    void lock() TSP_NOEXCEPT {
+        for (int spins = 0; spins < max_spins; ++spins) {
+            int expected = unlocked;
+            if (state.load(std::memory_order_relaxed) == unlocked &&
+                state.compare_exchange_weak(expected, locked,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed))
+                return;
+            pause();
+        }
+        // From now on, the lock is taken as contended, so that unlock wakes
+        // up a sleeper
+        while (state.exchange(contended, std::memory_order_acquire) !=
+               unlocked) {
+#if defined(__cpp_lib_atomic_wait)
+            state.wait(contended, std::memory_order_relaxed);
+#else
+            std::this_thread::yield();
+#endif
+        }
+    }
+
+    void unlock() TSP_NOEXCEPT {
+        if (state.exchange(unlocked, std::memory_order_release) == contended) {
+#if defined(__cpp_lib_atomic_wait)
+            state.notify_one();
+#endif
+        }
+    }
+
+private:
+    enum { unlocked, locked, contended };
+    enum { max_spins = 100 };
+
+    static void pause() TSP_NOEXCEPT {
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+        (defined(__x86_64__) || defined(__i386__))
+        __builtin_ia32_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    std::atomic<int> state;
+};
+
+/** \brief A spinlock alone on its cache line */
+struct alignas(64) padded_spinlock {
+    spinlock lock;
+};
+
+/** \brief Returns the lock of the stripe that address p hashes to
+ *
+ * The table is shared by the whole program. The low bits of p are dropped, as
+ * shared_ptr objects are at least 8 bytes apart, and the rest are mixed with
+ * a Fibonacci hash so that neighbouring objects use different stripes.
+ */
+inline spinlock &spinlock_for(const void *p) TSP_NOEXCEPT {
+    static padded_spinlock table[THROWING_PTR_ATOMIC_STRIPES];
+    const std::uint64_t address =
+            static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p));
+    const std::uint64_t hash = (address >> 3) * 0x9E3779B97F4A7C15ull;
+    return table[(hash >> 32) & (THROWING_PTR_ATOMIC_STRIPES - 1)].lock;
+}
+
+/** \brief Holds the lock of the stripe of an address for its lifetime */
+class spinlock_guard {
+public:
+    explicit spinlock_guard(const void *p) TSP_NOEXCEPT : l(spinlock_for(p)) {
+        l.lock();
+    }
+
+    ~spinlock_guard() { l.unlock(); }
+
+    spinlock_guard(const spinlock_guard &) = delete;
+    spinlock_guard &operator=(const spinlock_guard &) = delete;
+
+private:
+    spinlock &l;
+};
+
+} // namespace detail
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
@@ -0,0 +1,302 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/private/split_count_atomic.hpp
+ * \brief Lock-free atomic holder of a std::shared_ptr or std::weak_ptr, with
+ * split reference counts
+ *
+ * The held value lives in an immutable heap node. A single atomic word packs
+ * the address of the current node with a local count of the readers that are
+ * copying the value out of it. A reader increments the local count, which
+ * keeps the node alive, copies the value and then gives its count back:
+ * - to the word, if the node is still the current one;
+ * - otherwise to the node, whose count collects the readers that were still
+ * pending when a writer replaced it.
+ *
+ * A writer swaps in a new node and adds the local count it replaced to the
+ * old node. Whoever brings the node count to zero deletes the node. Node
+ * addresses cannot be reused while a reader holds a count, so there is no ABA
+ * problem. A null word stands for an empty value; its local count is
+ * meaningless and never given back.
+ *
+ * On 64-bit targets the address takes the low 48 bits and the count the high
+ * 16, which limits concurrent readers of the same node to 65535. This is not
+ * compatible with pointer tagging in the high bits (e.g. AArch64 MTE). On
+ * 32-bit targets a 64-bit word holds the address and a 32-bit count.
+ */
+
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+namespace detail {
+
+/** \brief Whether v is the empty std::shared_ptr, held as a null node */
+template <typename T> bool is_empty_value(const std::shared_ptr<T> &v) {
+    return nullptr == v.get() && !v.owner_before(std::shared_ptr<T>()) &&
+           !std::shared_ptr<T>().owner_before(v);
+}
+
+/** \brief Whether v is the empty std::weak_ptr, held as a null node */
+template <typename T> bool is_empty_value(const std::weak_ptr<T> &v) {
+    return !v.owner_before(std::weak_ptr<T>()) &&
+           !std::weak_ptr<T>().owner_before(v);
+}
+
+/** \brief Whether lhs and rhs store the same pointer and share ownership */
+template <typename T>
+bool equivalent_values(const std::shared_ptr<T> &lhs,
+                       const std::shared_ptr<T> &rhs) {
+    return lhs.get() == rhs.get() && !lhs.owner_before(rhs) &&
+           !rhs.owner_before(lhs);
+}
+
+/** \brief Whether lhs and rhs share ownership
+ *
+ * The stored pointer of a std::weak_ptr cannot be read without locking it, so
+ * weak pointers that alias different subobjects of the same owner are
+ * considered equivalent.
+ */
+template <typename T>
+bool equivalent_values(const std::weak_ptr<T> &lhs,
+                       const std::weak_ptr<T> &rhs) {
+    return !lhs.owner_before(rhs) && !rhs.owner_before(lhs);
+}
+
+/** \brief Returns the strongest of order and the ordering that a
+ * read-modify-write needs to publish or acquire a node.
+ */
+inline std::memory_order rmw_order(std::memory_order order) TSP_NOEXCEPT {
+    return order == std::memory_order_seq_cst ? std::memory_order_seq_cst
+                                              : std::memory_order_acq_rel;
+}
+
+/** \brief Returns order without its release part, the default failure
+ * ordering of a compare exchange
+ */
+inline std::memory_order failure_order(std::memory_order order) TSP_NOEXCEPT {
+    return order == std::memory_order_acq_rel
+                   ? std::memory_order_acquire
+                   : order == std::memory_order_release
+                             ? std::memory_order_relaxed
+                             : order;
+}
+
+/** \brief Atomic holder of a Value, std::shared_ptr<T> or std::weak_ptr<T> */
+template <typename Value> class split_count_atomic {
+public:
+    split_count_atomic() TSP_NOEXCEPT : word(0) {}
+
+    explicit split_count_atomic(Value desired) : word(make_word(desired)) {}
+
+    split_count_atomic(const split_count_atomic &) = delete;
+    split_count_atomic &operator=(const split_count_atomic &) = delete;
+
+    ~split_count_atomic() {
+        release_replaced(word.load(std::memory_order_acquire));
+    }
+
+    bool is_lock_free() const TSP_NOEXCEPT { return word.is_lock_free(); }
+
+    /** \brief Calls f with the held value and returns its result.
+     *
+     * f runs while the node is kept alive by a local count, so it can copy
+     * the value, or lock it, without copying it first.
+     */
+    template <typename F>
+    auto visit(F f, std::memory_order order) const
+            -> decltype(f(std::declval<const Value &>())) {
+        const std::uint64_t observed =
+                word.fetch_add(count_one, rmw_order(order));
+        node *const n = node_of(observed);
+        if (nullptr == n)
+            return f(Value());
+        return give_back_after(n, f);
+    }
+
+    Value load(std::memory_order order) const {
+        return visit([](const Value &v) { return v; }, order);
+    }
+
+    Value exchange(Value desired, std::memory_order order) {
+        const std::uint64_t replaced =
+                word.exchange(make_word(desired), rmw_order(order));
+        node *const n = node_of(replaced);
+        if (nullptr == n)
+            return Value();
+        Value result = n->value;
+        release_replaced(replaced);
+        return result;
+    }
+
+    void store(Value desired, std::memory_order order) {
+        release_replaced(word.exchange(make_word(desired), rmw_order(order)));
+    }
+
+    /** \brief Replaces the held value with desired if it is equivalent to
+     * expected, otherwise copies the held value into expected.
+     *
+     * Changes of the local count alone do not make the exchange fail, and
+     * neither does a concurrent replacement with an equivalent value, so the
+     * weak and strong exchanges behave the same.
+     *
+     * The node of desired is allocated before any count is taken, as in
+     * store(), so that std::bad_alloc leaves the held value untouched.
+     */
+    bool compare_exchange(Value &expected, Value desired,
+                          std::memory_order success,
+                          std::memory_order failure) {
+        const std::uint64_t desired_word = make_word(desired);
+        for (;;) {
+            std::uint64_t observed =
+                    word.fetch_add(count_one, rmw_order(failure));
+            node *const n = node_of(observed);
+            const bool matches =
+                    nullptr == n ? is_empty_value(expected)
+                                 : equivalent_values(n->value, expected);
+            if (!matches) {
+                if (nullptr != n) {
+                    expected = n->value;
+                    give_back(n);
+                } else {
+                    expected = Value();
+                }
+                release_replaced(desired_word);
+                return false;
+            }
+            // Only the local count can change while the node stays current
+            observed += count_one;
+            while (node_of(observed) == n &&
+                   !word.compare_exchange_weak(observed, desired_word,
+                                               rmw_order(success),
+                                               std::memory_order_relaxed)) {
+            }
+            if (nullptr != n) {
+                if (node_of(observed) == n)
+                    release_replaced(observed);
+                give_back(n);
+            }
+            if (node_of(observed) == n)
+                return true;
+            // Replaced by another writer: compare with its value
+        }
+    }
+
+    /** \brief Blocks until the held value is not equivalent to old */
+    void wait(const Value &old, std::memory_order order) const {
+        for (;;) {
+            const std::uint64_t observed = word.load(order);
+            node *const n = node_of(observed);
+            const bool same =
+                    nullptr == n ? is_empty_value(old)
+                                 : visit([&](const Value &v) {
+                                       return equivalent_values(v, old);
+                                   },
+                                         order);
+            if (!same)
+                return;
+#if defined(__cpp_lib_atomic_wait)
+            word.wait(observed, std::memory_order_relaxed);
+#else
+            std::this_thread::yield();
+#endif
+        }
+    }
+
+    void notify_one() TSP_NOEXCEPT {
+#if defined(__cpp_lib_atomic_wait)
+        word.notify_one();
+#endif
+    }
+
+    void notify_all() TSP_NOEXCEPT {
+#if defined(__cpp_lib_atomic_wait)
+        word.notify_all();
+#endif
+    }
+
+private:
+    struct node {
+        explicit node(Value v) : value(std::move(v)), count(0) {}
+
+        const Value value;
+        /** \brief Counts given to the node when it was replaced, minus the
+         * ones given back by its pending readers
+         */
+        std::atomic<long> count;
+    };
+
+    static const unsigned pointer_bits = sizeof(void *) == 8 ? 48 : 32;
+    static const std::uint64_t pointer_mask =
+            (std::uint64_t(1) << pointer_bits) - 1;
+    static const std::uint64_t count_one = std::uint64_t(1) << pointer_bits;
+
+    static node *node_of(std::uint64_t w) TSP_NOEXCEPT {
+        return reinterpret_cast<node *>(
+                static_cast<std::uintptr_t>(w & pointer_mask));
+    }
+
+    static long count_of(std::uint64_t w) TSP_NOEXCEPT {
+        return static_cast<long>(w >> pointer_bits);
+    }
+
+    /** \brief Returns the word of a new node holding v, or 0 if v is empty */
+    static std::uint64_t make_word(Value &v) {
+        if (is_empty_value(v))
+            return 0;
+        node *const n = new node(std::move(v));
+        const std::uint64_t w = reinterpret_cast<std::uintptr_t>(n);
+        assert((w & ~pointer_mask) == 0 && "address does not fit");
+        return w;
+    }
+
+    /** \brief Releases the word of a node that is no longer current */
+    static void release_replaced(std::uint64_t w) {
+        node *const n = node_of(w);
+        if (nullptr == n)
+            return;
+        const long pending = count_of(w);
+        if (n->count.fetch_add(pending, std::memory_order_acq_rel) ==
+            -pending)
+            delete n;
+    }
+
+    /** \brief Gives back a local count taken on n */
+    void give_back(node *n) const {
+        std::uint64_t observed = word.load(std::memory_order_relaxed);
+        while (node_of(observed) == n) {
+            if (word.compare_exchange_weak(observed, observed - count_one,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed))
+                return;
+        }
+        if (n->count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete n;
+    }
+
+    template <typename F>
+    auto give_back_after(node *n, F &f) const
+            -> decltype(f(std::declval<const Value &>())) {
+        struct guard {
+            const split_count_atomic *self;
+            node *n;
+            ~guard() { self->give_back(n); }
+        } g = {this, n};
+        return f(n->value);
+    }
+
+    mutable std::atomic<std::uint64_t> word;
+};
+
+} // namespace detail
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
@@ -0,0 +1,143 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/private/stack_trace.hpp
+ * \brief Implementation details
+ * This header file must not be included directly
+ * and definitions herein may change without notice
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <throwing/private/type_name.hpp>
+#include <throwing/private/compiler_checks.hpp>
+#if TSP_STACK_TRACE
+#include <execinfo.h>
+#include <unwind.h>
+#endif
+
+/** \brief Maximum number of return addresses recorded by null_ptr_exception
+ * when THROWING_PTR_BACKTRACE is defined
+ */
+#if !defined(THROWING_PTR_BACKTRACE_DEPTH)
+#define THROWING_PTR_BACKTRACE_DEPTH 32
+#endif
+
+namespace throwing {
+namespace detail {
+
+#if TSP_STACK_TRACE
+/** \brief State of a capture_stack_frames() walk */
+struct stack_frames_cursor {
+    const void **frames;
+    std::size_t capacity;
+    std::size_t size;
+    std::size_t skip;
+    const void *from;
+};
+
+/** \brief Records the return address of a frame, called by the unwinder */
+inline _Unwind_Reason_Code collect_stack_frame(_Unwind_Context *context,
+                                               void *arg) {
+    stack_frames_cursor &cursor = *static_cast<stack_frames_cursor *>(arg);
+    if (cursor.skip > 0) {
+        --cursor.skip;
+        return _URC_NO_REASON;
+    }
+    const void *const ip =
+            reinterpret_cast<const void *>(_Unwind_GetIP(context));
+    if (nullptr == ip)
+        return _URC_END_OF_STACK;
+    if (ip == cursor.from) {
+        cursor.size = 0;
+        cursor.from = nullptr;
+    }
+    if (cursor.size == cursor.capacity)
+        return nullptr == cursor.from ? _URC_END_OF_STACK : _URC_NO_REASON;
+    cursor.frames[cursor.size++] = ip;
+    return _URC_NO_REASON;
+}
+#endif
+
+/** \brief Stores in frames the return addresses of up to capacity frames of
+ * the calling thread and returns how many were stored.
+ *
+ * The frames start from the one whose return address is from, if it is found
+ * in the stack, and from the caller of this function otherwise. Neither
+ * allocates nor resolves symbols. Returns 0 unless THROWING_PTR_BACKTRACE is
+ * defined on a platform that supports stack traces.
+ */
+TSP_NOINLINE inline std::size_t
+capture_stack_frames(const void **frames, std::size_t capacity,
+                     const void *from = nullptr) TSP_NOEXCEPT {
+#if TSP_STACK_TRACE
+    stack_frames_cursor cursor = {frames, capacity, 0, 1, from};
+    _Unwind_Backtrace(&collect_stack_frame, &cursor);
+    return cursor.size;
+#else
+    static_cast<void>(frames);
+    static_cast<void>(capacity);
+    static_cast<void>(from);
+    return 0;
+#endif
+}
+
+/** \brief Returns a description of each of the size return addresses in
+ * frames, one per line.
+ *
+ * Each line holds the frame number, the module and, when the dynamic symbol
+ * table has it, the demangled name of the function and the offset in it.
+ * Programs linked with -rdynamic export the names of all their functions.
+ */
+inline std::string symbolize_stack_frames(const void *const *frames,
+                                          std::size_t size) {
+    std::string result;
+#if TSP_STACK_TRACE
+    char **symbols = 0 == size ? nullptr
+                               : backtrace_symbols(
+                                         const_cast<void *const *>(frames),
+                                         static_cast<int>(size));
+#endif
+    for (std::size_t i = 0; i < size; ++i) {
+        char prefix[32];
+        std::snprintf(prefix, sizeof(prefix), "#%-3u ",
+                      static_cast<unsigned>(i));
+        result += prefix;
+#if TSP_STACK_TRACE
+        if (nullptr != symbols) {
+            // glibc formats symbols as module(mangled+offset) [address]
+            const std::string symbol(symbols[i]);
+            const std::size_t open = symbol.find('(');
+            const std::size_t plus = symbol.find('+', open);
+            if (std::string::npos != open && std::string::npos != plus &&
+                plus > open + 1) {
+                result += symbol.substr(0, open + 1);
+                result += demangle(
+                        symbol.substr(open + 1, plus - open - 1).c_str());
+                result += symbol.substr(plus);
+            } else {
+                result += symbol;
+            }
+            result += '\n';
+            continue;
+        }
+#endif
+        char address[32];
+        std::snprintf(address, sizeof(address), "%p\n", frames[i]);
+        result += address;
+    }
+#if TSP_STACK_TRACE
+    std::free(symbols);
+#endif
+    return result;
+}
+
+} // namespace detail
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
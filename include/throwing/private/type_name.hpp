@@ -0,0 +1,57 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/private/type_name.hpp
+ * \brief Implementation details
+ * This header file must not be included directly
+ * and definitions herein may change without notice
+ */
+
+#pragma once
+#include <cstdlib>
+#include <string>
+#include <typeinfo>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace throwing {
+namespace detail {
+
+/** \brief Returns the human readable form of a name returned by
+ * std::type_info::name()
+ *
+ * The Itanium C++ ABI used by GCC and clang returns mangled names, which are
+ * demangled with abi::__cxa_demangle. Other implementations, such as MSVC,
+ * already return readable names, which are returned unchanged. So is a name
+ * that fails to demangle.
+ */
+inline std::string demangle(const char *name) {
+#if defined(__GNUG__)
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (0 == status && nullptr != demangled) {
+        std::string result(demangled);
+        std::free(demangled);
+        return result;
+    }
+    std::free(demangled);
+#endif
+    return name;
+}
+
+/** \brief Returns the human readable name of T
+ *
+ * The name is demangled on the first call and cached for the lifetime of the
+ * program; initialization of the cache is thread-safe and later calls do not
+ * allocate.
+ */
+template <typename T> const char *type_name() {
+    static const std::string name = demangle(typeid(T).name());
+    return name.c_str();
+}
+
+} // namespace detail
+} // namespace throwing
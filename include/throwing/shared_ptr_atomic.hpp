@@ -0,0 +1,311 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+/** \file throwing/shared_ptr_atomic.hpp
+ * \brief Overloads of the atomic_* functions for throwing::shared_ptr
+ *
+ * By default the functions forward to the std::shared_ptr overloads, which
+ * in libstdc++ and libc++ lock one of a small pool of mutexes picked by
+ * address. When THROWING_PTR_ATOMIC_SPINLOCK is defined, they lock one of
+ * THROWING_PTR_ATOMIC_STRIPES (128 by default) spinlocks instead, each on its
+ * own cache line, so that unrelated pointers rarely share a lock. A thread
+ * that cannot take the lock after a short spin sleeps, with std::atomic::wait
+ * in C++20 and by yielding otherwise. Both macros must have the same value in
+ * every translation unit of a program.
+ */
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <throwing/shared_ptr_core.hpp>
+#if defined(THROWING_PTR_ATOMIC_SPINLOCK)
+#include <throwing/private/spinlock_pool.hpp>
+#endif
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+
+#if defined(THROWING_PTR_ATOMIC_SPINLOCK) ||                                   \
+        !(!defined(__clang__) && defined(__GNUC__) &&                          \
+          __GNUC__ < 5) // These operations are not supported in GCC < 5.0
+
+namespace detail {
+
+#if defined(THROWING_PTR_ATOMIC_SPINLOCK)
+// The pointers replaced in *p and *expected are destroyed after the lock is
+// released, so that no destructor runs under it.
+
+template <typename T>
+bool atomic_is_lock_free_impl(const std::shared_ptr<T> *) TSP_NOEXCEPT {
+    return false;
+}
+
+template <typename T>
+std::shared_ptr<T> atomic_load_impl(const std::shared_ptr<T> *p,
+                                    std::memory_order) {
+    spinlock_guard guard(p);
+    return *p;
+}
+
+template <typename T>
+std::shared_ptr<T> atomic_exchange_impl(std::shared_ptr<T> *p,
+                                        std::shared_ptr<T> r,
+                                        std::memory_order) {
+    {
+        spinlock_guard guard(p);
+        p->swap(r);
+    }
+    return r;
+}
+
+template <typename T>
+void atomic_store_impl(std::shared_ptr<T> *p, std::shared_ptr<T> r,
+                       std::memory_order mo) {
+    atomic_exchange_impl(p, std::move(r), mo);
+}
+
+template <typename T>
+bool atomic_compare_exchange_strong_impl(std::shared_ptr<T> *p,
+                                         std::shared_ptr<T> *expected,
+                                         std::shared_ptr<T> desired,
+                                         std::memory_order,
+                                         std::memory_order) {
+    std::shared_ptr<T> replaced;
+    spinlock_guard guard(p);
+    if (p->get() == expected->get() && !p->owner_before(*expected) &&
+        !expected->owner_before(*p)) {
+        p->swap(desired);
+        return true;
+    }
+    replaced.swap(*expected);
+    *expected = *p;
+    return false;
+}
+
+template <typename T>
+bool atomic_compare_exchange_weak_impl(std::shared_ptr<T> *p,
+                                       std::shared_ptr<T> *expected,
+                                       std::shared_ptr<T> desired,
+                                       std::memory_order success,
+                                       std::memory_order failure) {
+    return atomic_compare_exchange_strong_impl(p, expected, std::move(desired),
+                                               success, failure);
+}
+#else
+template <typename T>
+bool atomic_is_lock_free_impl(const std::shared_ptr<T> *p) {
+    return std::atomic_is_lock_free(p);
+}
+
+template <typename T>
+std::shared_ptr<T> atomic_load_impl(const std::shared_ptr<T> *p,
+                                    std::memory_order mo) {
+    return std::atomic_load_explicit(p, mo);
+}
+
+template <typename T>
+std::shared_ptr<T> atomic_exchange_impl(std::shared_ptr<T> *p,
+                                        std::shared_ptr<T> r,
+                                        std::memory_order mo) {
+    return std::atomic_exchange_explicit(p, std::move(r), mo);
+}
+
+template <typename T>
+void atomic_store_impl(std::shared_ptr<T> *p, std::shared_ptr<T> r,
+                       std::memory_order mo) {
+    std::atomic_store_explicit(p, std::move(r), mo);
+}
+
+template <typename T>
+bool atomic_compare_exchange_strong_impl(std::shared_ptr<T> *p,
+                                         std::shared_ptr<T> *expected,
+                                         std::shared_ptr<T> desired,
+                                         std::memory_order success,
+                                         std::memory_order failure) {
+    return std::atomic_compare_exchange_strong_explicit(
+            p, expected, std::move(desired), success, failure);
+}
+
+template <typename T>
+bool atomic_compare_exchange_weak_impl(std::shared_ptr<T> *p,
+                                       std::shared_ptr<T> *expected,
+                                       std::shared_ptr<T> desired,
+                                       std::memory_order success,
+                                       std::memory_order failure) {
+    return std::atomic_compare_exchange_weak_explicit(
+            p, expected, std::move(desired), success, failure);
+}
+#endif
+
+} // namespace detail
+
+/** \brief Determines whether atomic access to the shared pointer pointed-to by
+ * p is lock-free.
+ */
+template <typename T, typename NullPolicy>
+bool atomic_is_lock_free(shared_ptr<T, NullPolicy> const *p) {
+    return detail::atomic_is_lock_free_impl(
+            reinterpret_cast<std::shared_ptr<T> const *>(p));
+}
+
+/** \brief Equivalent to atomic_load_explicit(p, std::memory_order_seq_cst)
+ */
+template <typename T, typename NullPolicy>
+shared_ptr<T, NullPolicy> atomic_load(const shared_ptr<T, NullPolicy> *p) {
+    TSP_PROBE2(atomic_load, static_cast<const void *>(p),
+               static_cast<int>(std::memory_order_seq_cst));
+    return detail::atomic_load_impl(
+            reinterpret_cast<const std::shared_ptr<T> *>(p),
+            std::memory_order_seq_cst);
+}
+
+/** \brief Returns the shared pointer pointed-to by p.
+ *
+ * As with the non-specialized std::atomic_load_explicit, mo cannot be
+ * std::memory_order_release or std::memory_order_acq_rel
+ */
+template <typename T, typename NullPolicy>
+shared_ptr<T, NullPolicy> atomic_load_explicit(
+        const shared_ptr<T, NullPolicy> *p, std::memory_order mo) {
+    TSP_PROBE2(atomic_load, static_cast<const void *>(p), static_cast<int>(mo));
+    return detail::atomic_load_impl(
+            reinterpret_cast<const std::shared_ptr<T> *>(p), mo);
+}
+
+/** \brief Equivalent to atomic_store_explicit(p, r, memory_order_seq_cst)
+ */
+template <typename T, typename NullPolicy>
+void atomic_store(shared_ptr<T, NullPolicy> *p, shared_ptr<T, NullPolicy> r) {
+    TSP_PROBE2(atomic_store, static_cast<const void *>(p),
+               static_cast<int>(std::memory_order_seq_cst));
+    detail::atomic_store_impl(reinterpret_cast<std::shared_ptr<T> *>(p),
+                              std::move(r.get_std_shared_ptr()),
+                              std::memory_order_seq_cst);
+}
+
+/** \brief Stores the shared pointer r in the shared pointer pointed-to by p
+ * atomically, effectively executing p->swap(r).
+ *
+ * As with the non-specialized std::atomic_store_explicit, mo cannot be
+ * std::memory_order_acquire or std::memory_order_acq_rel.
+ */
+template <typename T, typename NullPolicy>
+void atomic_store_explicit(shared_ptr<T, NullPolicy> *p,
+                           shared_ptr<T, NullPolicy> r, std::memory_order mo) {
+    TSP_PROBE2(atomic_store, static_cast<const void *>(p),
+               static_cast<int>(mo));
+    detail::atomic_store_impl(reinterpret_cast<std::shared_ptr<T> *>(p),
+                              std::move(r.get_std_shared_ptr()), mo);
+}
+
+/** \brief Equivalent to atomic_exchange(p, r, memory_order_seq_cst)
+ */
+template <typename T, typename NullPolicy>
+shared_ptr<T, NullPolicy> atomic_exchange(shared_ptr<T, NullPolicy> *p,
+                                          shared_ptr<T, NullPolicy> r) {
+    TSP_PROBE2(atomic_exchange, static_cast<const void *>(p),
+               static_cast<int>(std::memory_order_seq_cst));
+    return detail::atomic_exchange_impl(
+            reinterpret_cast<std::shared_ptr<T> *>(p),
+            std::move(r.get_std_shared_ptr()), std::memory_order_seq_cst);
+}
+
+/** \brief Stores the shared pointer r in the shared pointer pointed to by p and
+ * returns the value formerly pointed-to by p, atomically.
+ *
+ * Effectively executes p->swap(r) and returns a copy of r after the swap.
+ */
+template <typename T, typename NullPolicy>
+shared_ptr<T, NullPolicy> atomic_exchange_explicit(shared_ptr<T, NullPolicy> *p,
+                                                   shared_ptr<T, NullPolicy> r,
+                                                   std::memory_order mo) {
+    TSP_PROBE2(atomic_exchange, static_cast<const void *>(p),
+               static_cast<int>(mo));
+    return detail::atomic_exchange_impl(
+            reinterpret_cast<std::shared_ptr<T> *>(p),
+            std::move(r.get_std_shared_ptr()), mo);
+}
+
+/** \brief Equivalent to atomic_compare_exchange_weak_explicit(p, expected,
+ * desired, std::memory_order_seq_cst, std::memory_order_seq_cst)
+ */
+template <typename T, typename NullPolicy>
+bool atomic_compare_exchange_weak(shared_ptr<T, NullPolicy> *p,
+                                  shared_ptr<T, NullPolicy> *expected,
+                                  shared_ptr<T, NullPolicy> desired) {
+    const bool result = detail::atomic_compare_exchange_weak_impl(
+            reinterpret_cast<std::shared_ptr<T> *>(p),
+            reinterpret_cast<std::shared_ptr<T> *>(expected),
+            std::move(desired.get_std_shared_ptr()),
+            std::memory_order_seq_cst, std::memory_order_seq_cst);
+    TSP_PROBE3(atomic_compare_exchange, static_cast<const void *>(p),
+               static_cast<int>(std::memory_order_seq_cst), result);
+    return result;
+}
+
+/** \brief Equivalent to atomic_compare_exchange_strong_explicit(p, expected,
+ * desired, std::memory_order_seq_cst, std::memory_order_seq_cst)
+ */
+template <typename T, typename NullPolicy>
+bool atomic_compare_exchange_strong(shared_ptr<T, NullPolicy> *p,
+                                    shared_ptr<T, NullPolicy> *expected,
+                                    shared_ptr<T, NullPolicy> desired) {
+    const bool result = detail::atomic_compare_exchange_strong_impl(
+            reinterpret_cast<std::shared_ptr<T> *>(p),
+            reinterpret_cast<std::shared_ptr<T> *>(expected),
+            std::move(desired.get_std_shared_ptr()),
+            std::memory_order_seq_cst, std::memory_order_seq_cst);
+    TSP_PROBE3(atomic_compare_exchange, static_cast<const void *>(p),
+               static_cast<int>(std::memory_order_seq_cst), result);
+    return result;
+}
+
+/** \brief Compares the shared pointers pointed-to by p and expected. If they
+ * are equivalent (store the same pointer value, and either share ownership of
+ * the same object or are both empty), assigns desired into *p using the memory
+ * ordering constraints specified by success and returns true. If they are not
+ * equivalent, assigns *p into *expected using the memory ordering constraints
+ * specified by failure and returns false.
+ */
+template <typename T, typename NullPolicy>
+bool atomic_compare_exchange_strong_explicit(
+        shared_ptr<T, NullPolicy> *p, shared_ptr<T, NullPolicy> *expected,
+        shared_ptr<T, NullPolicy> desired, std::memory_order success,
+        std::memory_order failure) {
+    const bool result = detail::atomic_compare_exchange_strong_impl(
+            reinterpret_cast<std::shared_ptr<T> *>(p),
+            reinterpret_cast<std::shared_ptr<T> *>(expected),
+            std::move(desired.get_std_shared_ptr()), success, failure);
+    TSP_PROBE3(atomic_compare_exchange, static_cast<const void *>(p),
+               static_cast<int>(success), result);
+    return result;
+}
+
+/** \brief Compares the shared pointers pointed-to by p and expected. If they
+ * are equivalent (store the same pointer value, and either share ownership of
+ * the same object or are both empty), assigns desired into *p using the memory
+ * ordering constraints specified by success and returns true. If they are not
+ * equivalent, assigns *p into *expected using the memory ordering constraints
+ * specified by failure and returns false, but may fail spuriously.
+ */
+template <typename T, typename NullPolicy>
+bool atomic_compare_exchange_weak_explicit(shared_ptr<T, NullPolicy> *p,
+                                           shared_ptr<T, NullPolicy> *expected,
+                                           shared_ptr<T, NullPolicy> desired,
+                                           std::memory_order success,
+                                           std::memory_order failure) {
+    const bool result = detail::atomic_compare_exchange_weak_impl(
+            reinterpret_cast<std::shared_ptr<T> *>(p),
+            reinterpret_cast<std::shared_ptr<T> *>(expected),
+            std::move(desired.get_std_shared_ptr()), success, failure);
+    TSP_PROBE3(atomic_compare_exchange, static_cast<const void *>(p),
+               static_cast<int>(success), result);
+    return result;
+}
+#endif // atomic methods supported by compiler
+
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
@@ -0,0 +1,26 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+/** \file throwing/shared_ptr_hash.hpp
+ * \brief Specialization of std::hash for throwing::shared_ptr
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <throwing/shared_ptr_core.hpp>
+
+namespace std {
+
+/** \brief Template specialization of std::hash for throwing::shared_ptr<T>
+ */
+template <typename T, typename NullPolicy>
+struct hash<throwing::shared_ptr<T, NullPolicy>> {
+    size_t operator()(const throwing::shared_ptr<T, NullPolicy> &x) const {
+        return std::hash<typename throwing::shared_ptr<
+                T, NullPolicy>::element_type *>()(x.get());
+    }
+};
+
+} // namespace std
@@ -0,0 +1,28 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+/** \file throwing/shared_ptr_ostream.hpp
+ * \brief Stream insertion of throwing::shared_ptr
+ */
+
+#pragma once
+#include <iosfwd>
+#include <throwing/shared_ptr_core.hpp>
+
+namespace throwing {
+
+/** \brief Inserts the value of the pointer stored in ptr into the output stream
+ * os
+ *
+ * Equivalent to os << ptr.get().
+ * \return os
+ */
+template <typename T, typename NullPolicy, typename U, typename V>
+std::basic_ostream<U, V> &operator<<(std::basic_ostream<U, V> &os,
+                                     const shared_ptr<T, NullPolicy> &ptr) {
+    os << ptr.get();
+    return os;
+}
+
+} // namespace throwing
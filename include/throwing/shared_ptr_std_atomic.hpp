@@ -0,0 +1,293 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+/** \file throwing/shared_ptr_std_atomic.hpp
+ * \brief Specializations of std::atomic for throwing::shared_ptr and
+ * throwing::weak_ptr
+ *
+ * Only defined when the standard library provides
+ * std::atomic<std::shared_ptr<T>> and std::atomic<std::weak_ptr<T>>, that is
+ * when __cpp_lib_atomic_shared_ptr is defined (C++20). Each specialization
+ * holds the std specialization for the underlying std pointer and forwards
+ * every operation to it.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <throwing/shared_ptr_core.hpp>
+#include <throwing/private/compiler_checks.hpp>
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+
+namespace std {
+
+/** \brief Template specialization of std::atomic for
+ * throwing::shared_ptr<T>
+ *
+ * Has the interface and the guarantees of std::atomic<std::shared_ptr<T>>,
+ * which it wraps.
+ */
+template <typename T, typename NullPolicy>
+struct atomic<throwing::shared_ptr<T, NullPolicy>> {
+    /** \brief Type of the held pointer */
+    typedef throwing::shared_ptr<T, NullPolicy> value_type;
+
+    /** \brief Whether the operations are always lock-free */
+    static constexpr bool is_always_lock_free =
+            atomic<shared_ptr<T>>::is_always_lock_free;
+
+    /** \brief Constructs an atomic holding an empty pointer */
+    constexpr atomic() noexcept = default;
+
+    /** \brief Constructs an atomic holding an empty pointer */
+    constexpr atomic(nullptr_t) noexcept : atomic() {}
+
+    /** \brief Constructs an atomic holding desired */
+    atomic(value_type desired) noexcept
+            : a(std::move(desired.get_std_shared_ptr())) {}
+
+    atomic(const atomic &) = delete;
+    void operator=(const atomic &) = delete;
+
+    /** \brief Equivalent to store(desired) */
+    void operator=(value_type desired) noexcept { store(std::move(desired)); }
+
+    /** \brief Equivalent to store(nullptr) */
+    void operator=(nullptr_t) noexcept { store(nullptr); }
+
+    /** \brief Checks whether the operations are lock-free */
+    bool is_lock_free() const noexcept { return a.is_lock_free(); }
+
+    /** \brief Atomically replaces the held pointer with desired */
+    void store(value_type desired,
+               memory_order order = memory_order_seq_cst) noexcept {
+        TSP_PROBE2(atomic_store, static_cast<const void *>(this),
+                   static_cast<int>(order));
+        a.store(std::move(desired.get_std_shared_ptr()), order);
+    }
+
+    /** \brief Atomically returns a copy of the held pointer */
+    value_type load(memory_order order = memory_order_seq_cst) const noexcept {
+        TSP_PROBE2(atomic_load, static_cast<const void *>(this),
+                   static_cast<int>(order));
+        return value_type(a.load(order));
+    }
+
+    /** \brief Equivalent to load() */
+    operator value_type() const noexcept { return load(); }
+
+    /** \brief Atomically replaces the held pointer with desired and returns
+     * the pointer held before
+     */
+    value_type exchange(value_type desired,
+                        memory_order order = memory_order_seq_cst) noexcept {
+        TSP_PROBE2(atomic_exchange, static_cast<const void *>(this),
+                   static_cast<int>(order));
+        return value_type(
+                a.exchange(std::move(desired.get_std_shared_ptr()), order));
+    }
+
+    /** \brief Replaces the held pointer with desired if it is equivalent to
+     * expected (stores the same pointer and shares ownership), otherwise
+     * copies the held pointer into expected. May fail spuriously.
+     */
+    bool compare_exchange_weak(value_type &expected, value_type desired,
+                               memory_order success,
+                               memory_order failure) noexcept {
+        const bool result = a.compare_exchange_weak(
+                expected.get_std_shared_ptr(),
+                std::move(desired.get_std_shared_ptr()), success, failure);
+        TSP_PROBE3(atomic_compare_exchange, static_cast<const void *>(this),
+                   static_cast<int>(success), result);
+        return result;
+    }
+
+    /** \brief Replaces the held pointer with desired if it is equivalent to
+     * expected (stores the same pointer and shares ownership), otherwise
+     * copies the held pointer into expected.
+     */
+    bool compare_exchange_strong(value_type &expected, value_type desired,
+                                 memory_order success,
+                                 memory_order failure) noexcept {
+        const bool result = a.compare_exchange_strong(
+                expected.get_std_shared_ptr(),
+                std::move(desired.get_std_shared_ptr()), success, failure);
+        TSP_PROBE3(atomic_compare_exchange, static_cast<const void *>(this),
+                   static_cast<int>(success), result);
+        return result;
+    }
+
+    /** \brief As compare_exchange_weak(expected, desired, order, failure),
+     * where failure is order without its release part
+     */
+    bool
+    compare_exchange_weak(value_type &expected, value_type desired,
+                          memory_order order = memory_order_seq_cst) noexcept {
+        const bool result = a.compare_exchange_weak(
+                expected.get_std_shared_ptr(),
+                std::move(desired.get_std_shared_ptr()), order);
+        TSP_PROBE3(atomic_compare_exchange, static_cast<const void *>(this),
+                   static_cast<int>(order), result);
+        return result;
+    }
+
+    /** \brief As compare_exchange_strong(expected, desired, order, failure),
+     * where failure is order without its release part
+     */
+    bool compare_exchange_strong(
+            value_type &expected, value_type desired,
+            memory_order order = memory_order_seq_cst) noexcept {
+        const bool result = a.compare_exchange_strong(
+                expected.get_std_shared_ptr(),
+                std::move(desired.get_std_shared_ptr()), order);
+        TSP_PROBE3(atomic_compare_exchange, static_cast<const void *>(this),
+                   static_cast<int>(order), result);
+        return result;
+    }
+
+    /** \brief Blocks until the held pointer is not equivalent to old and
+     * notify_one() or notify_all() is called, or returns at once if it
+     * already differs
+     */
+    void wait(value_type old,
+              memory_order order = memory_order_seq_cst) const noexcept {
+        a.wait(std::move(old.get_std_shared_ptr()), order);
+    }
+
+    /** \brief Unblocks a thread blocked in wait(), if any */
+    void notify_one() noexcept { a.notify_one(); }
+
+    /** \brief Unblocks all the threads blocked in wait() */
+    void notify_all() noexcept { a.notify_all(); }
+
+private:
+    atomic<shared_ptr<T>> a;
+};
+
+/** \brief Template specialization of std::atomic for throwing::weak_ptr<T>
+ *
+ * Has the interface and the guarantees of std::atomic<std::weak_ptr<T>>,
+ * which it wraps.
+ */
+template <typename T, typename NullPolicy>
+struct atomic<throwing::weak_ptr<T, NullPolicy>> {
+    /** \brief Type of the held pointer */
+    typedef throwing::weak_ptr<T, NullPolicy> value_type;
+
+    /** \brief Whether the operations are always lock-free */
+    static constexpr bool is_always_lock_free =
+            atomic<weak_ptr<T>>::is_always_lock_free;
+
+    /** \brief Constructs an atomic holding an empty pointer */
+    constexpr atomic() noexcept = default;
+
+    /** \brief Constructs an atomic holding desired */
+    atomic(value_type desired) noexcept
+            : a(std::move(desired.get_std_weak_ptr())) {}
+
+    atomic(const atomic &) = delete;
+    void operator=(const atomic &) = delete;
+
+    /** \brief Equivalent to store(desired) */
+    void operator=(value_type desired) noexcept { store(std::move(desired)); }
+
+    /** \brief Checks whether the operations are lock-free */
+    bool is_lock_free() const noexcept { return a.is_lock_free(); }
+
+    /** \brief Atomically replaces the held pointer with desired */
+    void store(value_type desired,
+               memory_order order = memory_order_seq_cst) noexcept {
+        a.store(std::move(desired.get_std_weak_ptr()), order);
+    }
+
+    /** \brief Atomically returns a copy of the held pointer */
+    value_type load(memory_order order = memory_order_seq_cst) const noexcept {
+        return value_type(a.load(order));
+    }
+
+    /** \brief Equivalent to load() */
+    operator value_type() const noexcept { return load(); }
+
+    /** \brief Atomically replaces the held pointer with desired and returns
+     * the pointer held before
+     */
+    value_type exchange(value_type desired,
+                        memory_order order = memory_order_seq_cst) noexcept {
+        return value_type(
+                a.exchange(std::move(desired.get_std_weak_ptr()), order));
+    }
+
+    /** \brief Replaces the held pointer with desired if it is equivalent to
+     * expected (stores the same pointer and shares ownership), otherwise
+     * copies the held pointer into expected. May fail spuriously.
+     */
+    bool compare_exchange_weak(value_type &expected, value_type desired,
+                               memory_order success,
+                               memory_order failure) noexcept {
+        return a.compare_exchange_weak(expected.get_std_weak_ptr(),
+                                       std::move(desired.get_std_weak_ptr()),
+                                       success, failure);
+    }
+
+    /** \brief Replaces the held pointer with desired if it is equivalent to
+     * expected (stores the same pointer and shares ownership), otherwise
+     * copies the held pointer into expected.
+     */
+    bool compare_exchange_strong(value_type &expected, value_type desired,
+                                 memory_order success,
+                                 memory_order failure) noexcept {
+        return a.compare_exchange_strong(
+                expected.get_std_weak_ptr(),
+                std::move(desired.get_std_weak_ptr()), success, failure);
+    }
+
+    /** \brief As compare_exchange_weak(expected, desired, order, failure),
+     * where failure is order without its release part
+     */
+    bool
+    compare_exchange_weak(value_type &expected, value_type desired,
+                          memory_order order = memory_order_seq_cst) noexcept {
+        return a.compare_exchange_weak(expected.get_std_weak_ptr(),
+                                       std::move(desired.get_std_weak_ptr()),
+                                       order);
+    }
+
+    /** \brief As compare_exchange_strong(expected, desired, order, failure),
+     * where failure is order without its release part
+     */
+    bool compare_exchange_strong(
+            value_type &expected, value_type desired,
+            memory_order order = memory_order_seq_cst) noexcept {
+        return a.compare_exchange_strong(
+                expected.get_std_weak_ptr(),
+                std::move(desired.get_std_weak_ptr()), order);
+    }
+
+    /** \brief Blocks until the held pointer is not equivalent to old and
+     * notify_one() or notify_all() is called, or returns at once if it
+     * already differs
+     */
+    void wait(value_type old,
+              memory_order order = memory_order_seq_cst) const noexcept {
+        a.wait(std::move(old.get_std_weak_ptr()), order);
+    }
+
+    /** \brief Unblocks a thread blocked in wait(), if any */
+    void notify_one() noexcept { a.notify_one(); }
+
+    /** \brief Unblocks all the threads blocked in wait() */
+    void notify_all() noexcept { a.notify_all(); }
+
+private:
+    atomic<weak_ptr<T>> a;
+};
+
+} // namespace std
+
+#endif
+
+#include <throwing/private/clear_compiler_checks.hpp>
@@ -0,0 +1,158 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing/telemetry.hpp
+ * \brief Per-type counters of null dereferences
+ *
+ * Counting is opt-in: define THROWING_PTR_TELEMETRY in every translation unit
+ * of the program (e.g. on the compiler command line) and each null
+ * dereference that reaches the throw path, or the null handler when
+ * exceptions are disabled, increments a counter for the pointed-to type.
+ * Mixing translation units built with and without THROWING_PTR_TELEMETRY
+ * violates the one definition rule.
+ *
+ * Counters are only touched on the null path, so non-null dereferences cost
+ * the same with and without telemetry. Each counter is split in shards, each
+ * on its own cache line, and each thread increments the shard it was assigned
+ * on its first null dereference, so that threads hitting null pointers
+ * concurrently do not contend on a single cache line.
+ *
+ * The snapshot API is available whether or not counting is enabled.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <throwing/private/type_name.hpp>
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+
+/** \brief Number of null dereferences of a type */
+struct null_dereference_count {
+    /** \brief Readable name of the pointed-to type */
+    const char *type_name;
+    /** \brief Number of null dereferences since the program started */
+    std::uint64_t count;
+};
+
+namespace detail {
+
+/** \brief Number of shards each counter is split into */
+const std::size_t telemetry_shards = 16;
+
+/** \brief A shard of a counter, alone on its cache line */
+struct alignas(64) telemetry_shard {
+    std::atomic<std::uint64_t> count;
+};
+
+/** \brief Counter of the null dereferences of a type
+ *
+ * Counters register themselves in a lock-free list upon construction and are
+ * never removed.
+ */
+class telemetry_counter {
+public:
+    explicit telemetry_counter(const char *(*type_name_getter)())
+            : name(type_name_getter), next(nullptr) {
+        for (std::size_t i = 0; i < telemetry_shards; ++i)
+            shards[i].count.store(0, std::memory_order_relaxed);
+        auto &head = list_head();
+        next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(next, this,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+    }
+
+    telemetry_counter(const telemetry_counter &) = delete;
+    telemetry_counter &operator=(const telemetry_counter &) = delete;
+
+    void increment() TSP_NOEXCEPT {
+        shards[shard_index()].count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t total() const TSP_NOEXCEPT {
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < telemetry_shards; ++i)
+            result += shards[i].count.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    const char *type_name() const { return name(); }
+
+    const telemetry_counter *next_counter() const TSP_NOEXCEPT {
+        return next;
+    }
+
+    static std::atomic<telemetry_counter *> &list_head() {
+        static std::atomic<telemetry_counter *> head(nullptr);
+        return head;
+    }
+
+private:
+    static std::size_t shard_index() TSP_NOEXCEPT {
+        static std::atomic<std::size_t> next_index(0);
+        thread_local const std::size_t index =
+                next_index.fetch_add(1, std::memory_order_relaxed) %
+                telemetry_shards;
+        return index;
+    }
+
+    telemetry_shard shards[telemetry_shards];
+    const char *(*name)();
+    telemetry_counter *next;
+};
+
+/** \brief Returns the counter of the null dereferences of T */
+template <typename T> telemetry_counter &telemetry_counter_for() {
+    static telemetry_counter counter(&type_name<T>);
+    return counter;
+}
+
+/** \brief Counts a null dereference of T if THROWING_PTR_TELEMETRY is defined
+ */
+template <typename T> void count_null_dereference() TSP_NOEXCEPT {
+#if defined(THROWING_PTR_TELEMETRY)
+    telemetry_counter_for<T>().increment();
+#endif
+}
+
+} // namespace detail
+
+/** \brief Calls f(type_name, count) for each type with at least one counted
+ * null dereference.
+ *
+ * Does not allocate, except to demangle a type name the first time it is
+ * requested. Counts are read while other threads may be incrementing them, so
+ * each is a lower bound of the value at the time of the call.
+ */
+template <typename F> void for_each_null_dereference_count(F f) {
+    for (const detail::telemetry_counter *counter =
+                 detail::telemetry_counter::list_head().load(
+                         std::memory_order_acquire);
+         nullptr != counter; counter = counter->next_counter()) {
+        f(counter->type_name(), counter->total());
+    }
+}
+
+/** \brief Returns the counts of null dereferences of each type with at least
+ * one counted null dereference.
+ */
+inline std::vector<null_dereference_count> null_dereference_counts() {
+    std::vector<null_dereference_count> result;
+    for_each_null_dereference_count(
+            [&result](const char *type_name, std::uint64_t count) {
+                null_dereference_count entry = {type_name, count};
+                result.push_back(entry);
+            });
+    return result;
+}
+
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
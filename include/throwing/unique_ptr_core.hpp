@@ -0,0 +1,1096 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+/** \file throwing/unique_ptr_core.hpp
+ * \brief throwing::unique_ptr, without std::hash and stream insertion
+ *
+ * Include throwing/unique_ptr.hpp for all of them.
+ */
+
+#pragma once
+#include <cassert>
+#include <memory>
+#include <typeinfo>
+#include <throwing/fwd.hpp>
+#include <throwing/deref_result.hpp>
+#include <throwing/null_policy.hpp>
+#include <throwing/null_ptr_exception.hpp>
+#include <throwing/private/compiler_checks.hpp>
+
+namespace throwing {
+
+/** \class throwing::unique_ptr throwing/unique_ptr.hpp
+ * \brief unique_ptr that manages a single object
+ *
+ * throwing::unique_ptr is a smart pointer that owns and manages another object
+ * through a pointer and disposes of that object when the unique_ptr goes out of
+ * scope.
+ *
+ * The object is disposed of using the associated deleter when either of the
+ * following happens:
+ * - the managing unique_ptr object is destroyed
+ * - the managing unique_ptr object is assigned another pointer via operator= or
+ * reset().
+ *
+ * The object is disposed of using a potentially user-supplied deleter by
+ * calling get_deleter()(ptr). The default deleter uses the delete operator,
+ * which destroys the object and deallocates the memory.
+ *
+ * A unique_ptr may alternatively own no object, in which case it is called
+ * empty.
+ *
+ * NullPolicy selects what happens when a null pointer is dereferenced, see
+ * throw_on_null (the default), terminate_on_null, callback_on_null and
+ * unchecked_on_null. Pointers with different policies can be converted into
+ * each other and compared.
+ */
+template <typename T, typename Deleter, typename NullPolicy> class unique_ptr {
+public:
+    /** \brief type of the wrapped std::unique_ptr. */
+    typedef typename std::unique_ptr<T, Deleter> std_unique_ptr_type;
+    /** \brief type of the pointer to the pointed object. */
+    typedef typename std::unique_ptr<T, Deleter>::pointer pointer;
+    /** \brief type of the pointed object. */
+    typedef typename std::unique_ptr<T, Deleter>::element_type element_type;
+    /** \brief type of the deleter. */
+    typedef typename std::unique_ptr<T, Deleter>::deleter_type deleter_type;
+
+    // allow access to p for other throwing::unique_ptr instantiations
+    template <typename OtherT, typename OtherDeleter, typename OtherPolicy>
+    friend class unique_ptr;
+
+    /** \brief Constructs a unique_ptr that owns nothing.
+     *
+     * Value-initializes the stored pointer and the stored deleter.
+     * Requires that Deleter is DefaultConstructible and that construction does
+     * not throw an exception.
+     */
+    TSP_CONSTEXPR unique_ptr() TSP_NOEXCEPT = default;
+
+    /** \brief Constructs a unique_ptr that owns nothing.
+     *
+     * Value-initializes the stored pointer and the stored deleter.
+     * Requires that Deleter is DefaultConstructible and that construction does
+     * not throw an exception.
+     */
+    TSP_CONSTEXPR unique_ptr(std::nullptr_t) TSP_NOEXCEPT {}
+
+    /** \brief Constructs a unique_ptr which owns p.
+     *
+     * Initialises the stored pointer with ptr and value-initialises the stored
+     * deleter.
+     *
+     * Requires that Deleter is DefaultConstructible and that construction does
+     * not throw an exception.
+     */
+    explicit unique_ptr(pointer ptr) TSP_NOEXCEPT : p(ptr) {}
+
+    /** \brief Constructs a std::unique_ptr object which owns p
+     *
+     * Initialises the stored pointer with ptr and initialises the stored
+     * deleter with d1
+     *
+     * Requires that Deleter is nothrow-CopyConstructible
+     *
+     * @todo the current implementation fails for VS2013
+     */
+    unique_ptr(pointer ptr,
+               typename std::conditional<std::is_reference<Deleter>::value,
+                                         Deleter, const Deleter &>::type d1)
+            TSP_NOEXCEPT : p(ptr, std::forward<decltype(d1)>(d1)) {}
+
+    /** \brief Constructs a std::unique_ptr object which owns p
+     *
+     * Initialises the stored pointer with ptr.
+     * Moves d2 into stored_deleter.
+     */
+    unique_ptr(pointer ptr,
+               typename std::remove_reference<Deleter>::type &&d2) TSP_NOEXCEPT
+            : p(ptr, std::forward<decltype(d2)>(d2)) {}
+
+    /** \brief Constructs a unique_ptr by transferring ownership from u to
+     * *this.
+     *
+     * If Deleter is not a reference type, requires that it is
+     * nothrow-MoveConstructible (if Deleter is a reference, get_deleter() and
+     * u.get_deleter() after move construction reference the same value)
+     */
+    unique_ptr(unique_ptr &&u) TSP_NOEXCEPT : p(std::move(u.p)) {}
+
+    /** \brief Constructs a unique_ptr by transferring ownership from u to
+     * *this, where u is constructed with a specified deleter (E).
+     *
+     * It depends upon whether E is a reference type, as following:
+     * a) if E is a reference type, this deleter is copy constructed from u's
+     * deleter (requires that this construction does not throw)
+     * b) if E is a non-reference type, this deleter is move constructed from
+     * u's deleter (requires that this construction does not throw)
+     *
+     * This constructor only participates in overload resolution if all of the
+     * following is true:
+     * a) unique_ptr<U, E>::pointer is implicitly convertible to pointer
+     * b) U is not an array type
+     * c) Either Deleter is a reference type and E is the same type as D, or
+     * Deleter is not a reference type and E is implicitly convertible to D
+     */
+    template <class U, class E, class OtherPolicy>
+    unique_ptr(unique_ptr<U, E, OtherPolicy> &&u) TSP_NOEXCEPT
+            : p(std::move(u.get_std_unique_ptr())) {}
+
+    /** \brief Constructs a unique_ptr by transferring ownership from a
+     * std::unique_ptr u to *this, where u is constructed with a specified
+     * deleter (E).
+     *
+     * It depends upon whether E is a reference type, as following:
+     * a) if E is a reference type, this deleter is copy constructed from u's
+     * deleter (requires that this construction does not throw)
+     * b) if E is a non-reference type, this deleter is move constructed from
+     * u's deleter (requires that this construction does not throw)
+     *
+     * This constructor only participates in overload resolution if all of the
+     * following is true:
+     * a) std::unique_ptr<U, E>::pointer is implicitly convertible to pointer
+     * b) U is not an array type
+     * c) Either Deleter is a reference type and E is the same type as D, or
+     * Deleter is not a reference type and E is implicitly convertible to D
+     */
+    template <class U, class E>
+    unique_ptr(std::unique_ptr<U, E> &&u) TSP_NOEXCEPT : p(std::move(u)) {}
+
+    /** \brief Destructor
+     * If get() == nullptr there are no effects. Otherwise, the owned object is
+     * destroyed via get_deleter()(get()) on the underlying unique_ptr.
+     *
+     * Requires that get_deleter()(get()) does not throw exceptions.
+     */
+    ~unique_ptr() = default;
+
+    /** \brief Assignment operator
+     *
+     * Transfers ownership from r to *this as if by calling reset(r.release())
+     * followed by an assignment of get_deleter() from
+     * std::forward<E>(r.get_deleter()).
+     *
+     * If Deleter is not a reference type, requires that it is
+     * nothrow-MoveAssignable.
+     *
+     * If Deleter is a reference type, requires that
+     * std::remove_reference<Deleter>::type is nothrow-CopyAssignable.
+     */
+    unique_ptr &operator=(unique_ptr &&r) TSP_NOEXCEPT {
+        p = std::move(r.p);
+        return *this;
+    }
+
+    /** \brief Assignment operator
+     *
+     * Transfers ownership from r to *this as if by calling reset(r.release())
+     * followed by an assignment of get_deleter() from
+     * std::forward<E>(r.get_deleter()).
+     *
+     * If Deleter is not a reference type, requires that it is
+     * nothrow-MoveAssignable.
+     *
+     * If Deleter is a reference type, requires that
+     * std::remove_reference<Deleter>::type is nothrow-CopyAssignable.
+     *
+     * Only participates in overload resolution if U is not an array type and
+     * unique_ptr<U,E>::pointer is implicitly convertible to pointer and
+     * std::is_assignable<Deleter&, E&&>::value is true (since C++17).
+     */
+    template <class U, class E, class OtherPolicy>
+    unique_ptr &operator=(unique_ptr<U, E, OtherPolicy> &&r) TSP_NOEXCEPT {
+        p = std::move(r.p);
+        return *this;
+    }
+
+    /** \brief Assignment from std::unique_ptr operator
+     *
+     * Transfers ownership from a std::unique_ptr r to *this as if by calling
+     * reset(r.release()) followed by an assignment of get_deleter() from
+     * std::forward<E>(r.get_deleter()).
+     *
+     * If Deleter is not a reference type, requires that it is
+     * nothrow-MoveAssignable.
+     *
+     * If Deleter is a reference type, requires that
+     * std::remove_reference<Deleter>::type is nothrow-CopyAssignable.
+     *
+     * Only participates in overload resolution if U is not an array type and
+     * unique_ptr<U,E>::pointer is implicitly convertible to pointer and
+     * std::is_assignable<Deleter&, E&&>::value is true (since C++17).
+     */
+    template <class U, class E>
+    unique_ptr &operator=(std::unique_ptr<U, E> &&r) TSP_NOEXCEPT {
+        p = std::move(r);
+        return *this;
+    }
+
+    /** \brief Assignment operator
+     *
+     * Effectively the same as calling reset().
+     */
+    unique_ptr &operator=(std::nullptr_t) TSP_NOEXCEPT {
+        p = nullptr;
+        return *this;
+    }
+
+    /** \brief Releases the ownership of the managed object if any.
+     *
+     * get() returns nullptr after the call.
+     *
+     * \return Pointer to the managed object or nullptr if there was no managed
+     * object, i.e. the value which would be returned by get() before the call.
+     */
+    pointer release() TSP_NOEXCEPT { return p.release(); }
+
+    /** \brief Replaces the managed object.
+     *
+     * Given current_ptr, the pointer that was managed by *this, performs the
+     * following actions, in this order:
+     *
+     * - Saves a copy of the current pointer old_ptr = current_ptr
+     * - Overwrites the current pointer with the argument current_ptr = ptr
+     * - If the old pointer was non-empty, deletes the previously managed object
+     * if(old_ptr != nullptr) get_deleter()(old_ptr).
+     */
+    void reset(pointer ptr = pointer()) TSP_NOEXCEPT { p.reset(ptr); }
+
+    /** \brief Swaps the managed objects and associated deleters of *this and
+     * another unique_ptr object other.
+     */
+    void swap(unique_ptr &other) TSP_NOEXCEPT { p.swap(other.p); }
+
+    /** \brief Returns a pointer to the managed object or nullptr if no object
+     * is owned.
+     */
+    pointer get() const TSP_NOEXCEPT { return p.get(); }
+
+    /** \brief Returns the deleter object which would be used for destruction of
+     * the managed object.
+     */
+    Deleter &get_deleter() TSP_NOEXCEPT { return p.get_deleter(); }
+
+    /** \brief Returns the deleter object which would be used for destruction of
+     * the managed object.
+     */
+    const Deleter &get_deleter() const TSP_NOEXCEPT { return p.get_deleter(); }
+
+    /** \brief Checks whether *this owns an object, i.e. whether
+     * get() != nullptr.
+     */
+    explicit operator bool() const TSP_NOEXCEPT { return p.operator bool(); }
+
+    /** \brief Dereferences the stored pointer.
+     *
+     * \throw null_ptr_exception<T> if the pointer is null and NullPolicy is
+     * throw_on_null
+     */
+    typename std::add_lvalue_reference<T>::type operator*() const {
+        if (TSP_UNLIKELY(nullptr == get()))
+            NullPolicy::template null_dereference<T>();
+        return *p;
+    }
+
+    /** \brief Dereferences the stored pointer.
+     *
+     * \throw null_ptr_exception<T> if the pointer is null and NullPolicy is
+     * throw_on_null
+     */
+    pointer operator->() const {
+        const auto ptr = get();
+        if (TSP_UNLIKELY(nullptr == ptr))
+            NullPolicy::template null_dereference<T>();
+        return ptr;
+    }
+
+    /** \brief Returns the stored pointer, which must not be null.
+     *
+     * The pointer is not checked; the optimizer is told it is not null, so
+     * that later checked dereferences of the same pointer can drop their test.
+     * The behavior is undefined if the pointer is null. Builds where NDEBUG is
+     * not defined assert instead.
+     */
+    pointer get_nonnull() const TSP_NOEXCEPT {
+        const auto ptr = get();
+        assert(nullptr != ptr && "get_nonnull() called on a null unique_ptr");
+        TSP_ASSUME(nullptr != ptr);
+        return ptr;
+    }
+
+    /** \brief Dereferences the stored pointer, which must not be null.
+     *
+     * Equivalent to *get_nonnull().
+     */
+    typename std::add_lvalue_reference<T>::type deref_unchecked() const
+            TSP_NOEXCEPT {
+        return *get_nonnull();
+    }
+
+    /** \brief Dereferences the stored pointer without throwing.
+     *
+     * \return a deref_result referencing the pointed-to object, or holding a
+     * null_ptr_exception<T> error if the pointer is null
+     */
+    deref_result<T> try_deref() const TSP_NOEXCEPT {
+        return deref_result<T>(get());
+    }
+
+    /** \brief Returns a copy of the pointed-to object, or default_value
+     * converted to T if the pointer is null.
+     */
+    template <typename U>
+    typename detail::value_or_result<T, U>::type
+    value_or(U &&default_value) const {
+        return try_deref().value_or(std::forward<U>(default_value));
+    }
+
+    /** \brief Returns f(*get()) if the pointer is not null, otherwise a
+     * default constructed result, see deref_result::and_then.
+     */
+    template <typename F>
+    auto and_then(F &&f) const -> decltype(f(std::declval<T &>())) {
+        return try_deref().and_then(std::forward<F>(f));
+    }
+
+    /** \brief Returns reference to the wrapped std::unique_ptr
+     */
+    std_unique_ptr_type &get_std_unique_ptr() TSP_NOEXCEPT { return p; }
+
+    /** \brief Returns const reference to the wrapped std::unique_ptr
+     */
+    const std_unique_ptr_type &get_std_unique_ptr() const TSP_NOEXCEPT {
+        return p;
+    }
+
+private:
+    std_unique_ptr_type p;
+};
+
+/** \brief unique_ptr that manages a dynamically-allocated array of objects
+ *
+ * throwing::unique_ptr is a smart pointer that owns and manages another object
+ * through a pointer and disposes of that object when the unique_ptr goes out of
+ * scope.
+ *
+ * The object is disposed of using the associated deleter when either of the
+ * following happens:
+ * - the managing unique_ptr object is destroyed
+ * - the managing unique_ptr object is assigned another pointer via operator= or
+ * reset().
+ *
+ * The object is disposed of using a potentially user-supplied deleter by
+ * calling get_deleter()(ptr). The default deleter uses the delete operator,
+ * which destroys the object and deallocates the memory.
+ *
+ * A unique_ptr may alternatively own no object, in which case it is called
+ * empty.
+ *
+ * NullPolicy selects what happens when operator[] is called on a null pointer.
+ */
+template <typename T, typename Deleter, typename NullPolicy>
+class unique_ptr<T[], Deleter, NullPolicy> {
+public:
+    /** \brief type of the wrapped std::unique_ptr. */
+    typedef typename std::unique_ptr<T[], Deleter> std_unique_ptr_type;
+    /** \brief type of the pointer to the pointed objects. */
+    typedef typename std::unique_ptr<T[], Deleter>::pointer pointer;
+    /** \brief type of the pointed objects. */
+    typedef typename std::unique_ptr<T[], Deleter>::element_type element_type;
+    /** \brief type of the deleter. */
+    typedef typename std::unique_ptr<T[], Deleter>::deleter_type deleter_type;
+
+    // allow access to p for other throwing::unique_ptr instantiations
+    template <typename OtherT, typename OtherDeleter, typename OtherPolicy>
+    friend class unique_ptr;
+
+    /** \brief Constructs a throwing::unique_ptr that owns nothing.
+     *
+     * Value-initializes the stored pointer and the stored deleter.
+     * Requires that Deleter is DefaultConstructible and that construction does
+     * not throw an exception.
+     */
+    TSP_CONSTEXPR unique_ptr() TSP_NOEXCEPT = default;
+
+    /** \brief Constructs a throwing::unique_ptr that owns nothing.
+     *
+     * Value-initializes the stored pointer and the stored deleter.
+     * Requires that Deleter is DefaultConstructible and that construction does
+     * not throw an exception.
+     */
+    TSP_CONSTEXPR unique_ptr(std::nullptr_t) TSP_NOEXCEPT {}
+
+    /** \brief Constructs a throwing::unique_ptr which owns p.
+     *
+     * Initialises the stored pointer with ptr and value-initialises the stored
+     * deleter.
+     *
+     * Requires that Deleter is DefaultConstructible and that construction does
+     * not throw an exception.
+     *
+     * This constructor is ill-formed if Deleter is of pointer or reference
+     * type. (until C++17)
+     *
+     * This overload only participates in overload resolution if
+     * std::is_default_constructible<Deleter>::value is true and Deleter is not
+     * a pointer type. The program is ill-formed if this constructor is selected
+     * by class template argument deduction. (since C++17)
+     *
+     * This overload will not participate in overload resolution unless one of
+     * the following is true:
+     * - U is the same type as pointer, or
+     * - U is std::nullptr_t, or
+     * - pointer is the same type as element_type* and U is some pointer type V*
+     * such that V(*)[] is implicitly convertible to element_type(*)[]
+     */
+    template <class U> explicit unique_ptr(U ptr) TSP_NOEXCEPT : p(ptr) {}
+
+    /** \brief Constructs a throwing::unique_ptr object which owns ptr
+     *
+     * Initialises the stored pointer with ptr and initialises the stored
+     * deleter with d1
+     *
+     * This overload will not participate in overload resolution unless one of
+     * the following is true:
+     * - U is the same type as pointer, or
+     * - U is std::nullptr_t, or
+     * - pointer is the same type as element_type* and U is some pointer type V*
+     * such that V(*)[] is implicitly convertible to element_type(*)[]
+     *
+     * @todo the current implementation fails for VS2013
+     */
+    template <class U>
+    unique_ptr(U ptr,
+               typename std::conditional<std::is_reference<Deleter>::value,
+                                         Deleter, const Deleter &>::type d1)
+            TSP_NOEXCEPT : p(ptr, std::forward<decltype(d1)>(d1)) {}
+
+    /** \brief Constructs a throwing::unique_ptr object which owns ptr
+     *
+     * Initialises the stored pointer with ptr.
+     * Moves d2 into stored_deleter.
+     *
+     * This overload will not participate in overload resolution unless one of
+     * the following is true:
+     * - U is the same type as pointer, or
+     * - U is std::nullptr_t, or
+     * - pointer is the same type as element_type* and U is some pointer type V*
+     * such that V(*)[] is implicitly convertible to element_type(*)[]
+     */
+    template <class U>
+    unique_ptr(U ptr,
+               typename std::remove_reference<Deleter>::type &&d2) TSP_NOEXCEPT
+            : p(ptr, std::forward<decltype(d2)>(d2)) {}
+
+    /** \brief Constructs a unique_ptr by transferring ownership from u to
+     * *this.
+     *
+     * If Deleter is not a reference type, requires that it is
+     * nothrow-MoveConstructible (if Deleter is a reference, get_deleter() and
+     * u.get_deleter() after move construction reference the same value)
+     */
+    unique_ptr(unique_ptr &&u) TSP_NOEXCEPT : p(std::move(u.p)) {}
+
+    /** \brief Constructs a unique_ptr by transferring ownership from u to
+     * *this, where u is constructed with a specified deleter (E).
+     *
+     * It depends upon whether E is a reference type, as following:
+     * a) if E is a reference type, this deleter is copy constructed from u's
+     * deleter (requires that this construction does not throw)
+     * b) if E is a non-reference type, this deleter is move constructed from
+     * u's deleter (requires that this construction does not throw)
+     *
+     * This constructor only participates in overload resolution if all of the
+     * following are true:
+     * a) unique_ptr<U, E>::pointer is implicitly convertible to pointer
+     * b) U is an array type
+     * c) pointer is the same type as element_type*
+     * d) unique_ptr<U,E>::pointer is the same type as
+     * unique_ptr<U,E>::element_type*
+     * e) unique_ptr<U,E>::element_type(*)[] is convertible to element_type(*)[]
+     * f) Either Deleter is a reference type and E is the same type as Deleter,
+     * or Deleter is not a reference type and E is implicitly convertible to
+     * Deleter.
+     */
+    template <class U, class E, class OtherPolicy>
+    unique_ptr(unique_ptr<U, E, OtherPolicy> &&u) TSP_NOEXCEPT
+            : p(std::move(u.get_std_unique_ptr())) {}
+
+    /** \brief Constructs a unique_ptr by transferring ownership from u to
+     * *this, where u is constructed with a specified deleter (E).
+     *
+     * It depends upon whether E is a reference type, as following:
+     * a) if E is a reference type, this deleter is copy constructed from u's
+     * deleter (requires that this construction does not throw)
+     * b) if E is a non-reference type, this deleter is move constructed from
+     * u's deleter (requires that this construction does not throw)
+     *
+     * This constructor only participates in overload resolution if all of the
+     * following are true:
+     * a) unique_ptr<U, E>::pointer is implicitly convertible to pointer
+     * b) U is an array type
+     * c) pointer is the same type as element_type*
+     * d) unique_ptr<U,E>::pointer is the same type as
+     * unique_ptr<U,E>::element_type*
+     * e) unique_ptr<U,E>::element_type(*)[] is convertible to element_type(*)[]
+     * f) Either Deleter is a reference type and E is the same type as Deleter,
+     * or Deleter is not a reference type and E is implicitly convertible to
+     * Deleter.
+     */
+    template <class U, class E>
+    unique_ptr(std::unique_ptr<U, E> &&u) TSP_NOEXCEPT : p(std::move(u)) {}
+
+    /** \brief Destructor
+     * If get() == nullptr there are no effects. Otherwise, the owned object is
+     * destroyed via get_deleter()(get()) on the underlying unique_ptr.
+     *
+     * Requires that get_deleter()(get()) does not throw exceptions.
+     */
+    ~unique_ptr() = default;
+
+    /** \brief Assignment operator
+     *
+     * Transfers ownership from r to *this as if by calling reset(r.release())
+     * followed by an assignment of get_deleter() from
+     * std::forward<E>(r.get_deleter()).
+     *
+     * If Deleter is not a reference type, requires that it is
+     * nothrow-MoveAssignable.
+     *
+     * If Deleter is a reference type, requires that
+     * std::remove_reference<Deleter>::type is nothrow-CopyAssignable.
+     */
+    unique_ptr &operator=(unique_ptr &&r) TSP_NOEXCEPT {
+        p = std::move(r.p);
+        return *this;
+    }
+
+    /** \brief Assignment operator
+     *
+     * Transfers ownership from r to *this as if by calling reset(r.release())
+     * followed by an assignment of get_deleter() from
+     * std::forward<E>(r.get_deleter()).
+     *
+     * If Deleter is not a reference type, requires that it is
+     * nothrow-MoveAssignable.
+     *
+     * If Deleter is a reference type, requires that
+     * std::remove_reference<Deleter>::type is nothrow-CopyAssignable.
+     *
+     * Only participates in overload resolution if all of the following is true:
+     * - U is an array type
+     * - pointer is the same type as element_type*
+     * - unique_ptr<U,E>::pointer is the same type as
+     * unique_ptr<U,E>::element_type*
+     * - unique_ptr<U,E>::element_type(*)[] is convertible to element_type(*)[]
+     * - std::is_assignable<Deleter&, E&&>::value is true
+     */
+    template <class U, class E, class OtherPolicy>
+    unique_ptr &operator=(unique_ptr<U, E, OtherPolicy> &&r) TSP_NOEXCEPT {
+        p = std::move(r.p);
+        return *this;
+    }
+
+    /** \brief Assignment from std::unique_ptr operator
+     *
+     * Transfers ownership from r to *this as if by calling reset(r.release())
+     * followed by an assignment of get_deleter() from
+     * std::forward<E>(r.get_deleter()).
+     *
+     * If Deleter is not a reference type, requires that it is
+     * nothrow-MoveAssignable.
+     *
+     * If Deleter is a reference type, requires that
+     * std::remove_reference<Deleter>::type is nothrow-CopyAssignable.
+     *
+     * Only participates in overload resolution if all of the following is true:
+     * - U is an array type
+     * - pointer is the same type as element_type*
+     * - unique_ptr<U,E>::pointer is the same type as
+     * unique_ptr<U,E>::element_type*
+     * - unique_ptr<U,E>::element_type(*)[] is convertible to element_type(*)[]
+     * - std::is_assignable<Deleter&, E&&>::value is true
+     */
+    template <class U, class E>
+    unique_ptr &operator=(std::unique_ptr<U, E> &&r) TSP_NOEXCEPT {
+        p = std::move(r);
+        return *this;
+    }
+
+    /** \brief Assignment operator
+     *
+     * Effectively the same as calling reset().
+     */
+    unique_ptr &operator=(std::nullptr_t) TSP_NOEXCEPT {
+        p = nullptr;
+        return *this;
+    }
+
+    /** \brief Releases the ownership of the managed object if any.
+     *
+     * get() returns nullptr after the call.
+     *
+     * \return Pointer to the managed object or nullptr if there was no managed
+     * object, i.e. the value which would be returned by get() before the call.
+     */
+    pointer release() TSP_NOEXCEPT { return p.release(); }
+
+    /** \brief Replaces the managed object.
+     *
+     * Given current_ptr, the pointer that was managed by *this, performs the
+     * following actions, in this order:
+     *
+     * - Saves a copy of the current pointer old_ptr = current_ptr
+     * - Overwrites the current pointer with the argument current_ptr = ptr
+     * - If the old pointer was non-empty, deletes the previously managed object
+     * if(old_ptr != nullptr) get_deleter()(old_ptr).
+     */
+    void reset(pointer ptr = pointer()) TSP_NOEXCEPT { p.reset(ptr); }
+
+    /** \brief Replaces the managed object.
+     *
+     * Given current_ptr, the pointer that was managed by *this, performs the
+     * following actions, in this order:
+     *
+     * - Saves a copy of the current pointer old_ptr = current_ptr
+     * - Overwrites the current pointer with the argument current_ptr = ptr
+     * - If the old pointer was non-empty, deletes the previously managed object
+     * if(old_ptr != nullptr) get_deleter()(old_ptr).
+     *
+     * Will only participate in overload resolution if either:
+     * - U is the same type as pointer, or
+     * - pointer is the same type as element_type* and U is a pointer type V*
+     * such that V(*)[] is convertible to element_type(*)[].
+     * (available since C++17)
+     */
+    template <class U> void reset(U ptr) TSP_NOEXCEPT { p.reset(ptr); }
+
+    /** \brief Equivalent to reset(pointer())
+     */
+    void reset(std::nullptr_t ptr = nullptr) TSP_NOEXCEPT { p.reset(ptr); }
+
+    /** \brief Swaps the managed objects and associated deleters of *this and
+     * another unique_ptr object other.
+     */
+    void swap(unique_ptr &other) TSP_NOEXCEPT { p.swap(other.p); }
+
+    /** \brief Returns a pointer to the managed object or nullptr if no object
+     * is owned.
+     */
+    pointer get() const TSP_NOEXCEPT { return p.get(); }
+
+    /** \brief Returns the deleter object which would be used for destruction of
+     * the managed object.
+     */
+    Deleter &get_deleter() TSP_NOEXCEPT { return p.get_deleter(); }
+
+    /** \brief Returns the deleter object which would be used for destruction of
+     * the managed object.
+     */
+    const Deleter &get_deleter() const TSP_NOEXCEPT { return p.get_deleter(); }
+
+    /** \brief Checks whether *this owns an object, i.e. whether
+     * get() != nullptr.
+     */
+    explicit operator bool() const TSP_NOEXCEPT { return p.operator bool(); }
+
+    /** \brief provides access to elements of an array managed by a unique_ptr.
+     *
+     * The parameter i shall be less than the number of elements in the array;
+     * otherwise, the behavior is undefined.
+     *
+     * \throw throwing::null_ptr_exception<element_type> if the unique_ptr is
+     * empty and NullPolicy is throw_on_null
+     */
+    T &operator[](size_t i) const {
+        if (TSP_UNLIKELY(!p))
+            NullPolicy::template null_dereference<element_type>();
+        return p[i];
+    }
+
+    /** \brief Returns the stored pointer, which must not be null.
+     *
+     * The pointer is not checked; the optimizer is told it is not null, so
+     * that later checked accesses through the same pointer can drop their
+     * test. The behavior is undefined if the pointer is null. Builds where
+     * NDEBUG is not defined assert instead.
+     */
+    pointer get_nonnull() const TSP_NOEXCEPT {
+        const auto ptr = get();
+        assert(nullptr != ptr && "get_nonnull() called on a null unique_ptr");
+        TSP_ASSUME(nullptr != ptr);
+        return ptr;
+    }
+
+    /** \brief provides access to elements of an array managed by a unique_ptr,
+     * which must not be empty.
+     *
+     * Equivalent to get_nonnull()[i].
+     */
+    T &index_unchecked(size_t i) const TSP_NOEXCEPT { return get_nonnull()[i]; }
+
+    /** \brief Returns reference to the wrapped std::unique_ptr
+     */
+    std_unique_ptr_type &get_std_unique_ptr() TSP_NOEXCEPT { return p; }
+
+    /** \brief Returns const reference to the wrapped std::unique_ptr
+     */
+    const std_unique_ptr_type &get_std_unique_ptr() const TSP_NOEXCEPT {
+        return p;
+    }
+
+private:
+    std::unique_ptr<T[], Deleter> p;
+};
+
+/** \namespace throwing::detail
+ * \brief Helpers for make_unique type resolution, see n3656
+ * \see https://isocpp.org/blog/2013/04/n3656-make-unique-revision-1
+ */
+namespace detail {
+/** \brief true for throwing::unique_ptr to single object
+ */
+template <class T> struct _Unique_if {
+    typedef throwing::unique_ptr<T> _Single_object;
+};
+
+/** \brief true for throwing::unique_ptr to arrays of unknown length
+ */
+template <class T> struct _Unique_if<T[]> {
+    typedef throwing::unique_ptr<T[]> _Unknown_bound;
+};
+
+/** \brief true for throwing::unique_ptr to arrays of known length
+ */
+template <class T, size_t N> struct _Unique_if<T[N]> {
+    typedef void _Known_bound;
+};
+} // namespace detail
+
+/** \brief Constructs an object of non-array type T and wraps it in a
+ * throwing::unique_ptr using args as the parameter list for the constructor of
+ * T.
+ *
+ * Equivalent to: unique_ptr<T>(new T(std::forward<Args>(args)...))
+ *
+ * This overload only participates in overload resolution if T is not an array
+ * type.
+ */
+template <class T, class... Args>
+typename detail::_Unique_if<T>::_Single_object make_unique(Args &&... args) {
+    unique_ptr<T> result(new T(std::forward<Args>(args)...));
+    TSP_PROBE3(make_unique, typeid(T).name(), sizeof(T),
+               static_cast<const void *>(result.get()));
+    return result;
+}
+
+/** \brief Constructs an array of unknown bound T and wraps it in a
+ * throwing::unique_ptr
+ *
+ * Equivalent to: unique_ptr<T>(new typename
+ * std::remove_extent<T>::type[size]())
+ *
+ * This overload only participates in overload resolution if T is an array of
+ * unknown bound.
+ */
+template <class T>
+typename detail::_Unique_if<T>::_Unknown_bound make_unique(size_t n) {
+    typedef typename std::remove_extent<T>::type U;
+    unique_ptr<T> result(new U[n]());
+    TSP_PROBE3(make_unique, typeid(T).name(), n * sizeof(U),
+               static_cast<const void *>(result.get()));
+    return result;
+}
+
+/** \brief Construction of arrays of known bound is disallowed.
+ */
+template <class T, class... Args>
+typename detail::_Unique_if<T>::_Known_bound make_unique(Args &&...) = delete;
+
+/** \brief Compare two unique_ptr objects
+ * \return lhs.get() == rhs.get()
+ */
+template <class T1, class D1, class P1, class T2, class D2, class P2>
+bool operator==(const unique_ptr<T1, D1, P1> &lhs,
+                const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs.get_std_unique_ptr() == rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return !(lhs.get() == rhs.get())
+ */
+template <class T1, class D1, class P1, class T2, class D2, class P2>
+bool operator!=(const unique_ptr<T1, D1, P1> &lhs,
+                const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs.get_std_unique_ptr() != rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return std::less<CT>()(lhs.get(), rhs.get()),  where CT is
+ * std::common_type<unique_ptr<T1, D1>::pointer, unique_ptr<T2,
+ * D2>::pointer>::type
+ */
+template <class T1, class D1, class P1, class T2, class D2, class P2>
+bool operator<(const unique_ptr<T1, D1, P1> &lhs,
+               const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs.get_std_unique_ptr() < rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return !(rhs < lhs)
+ */
+template <class T1, class D1, class P1, class T2, class D2, class P2>
+bool operator<=(const unique_ptr<T1, D1, P1> &lhs,
+                const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs.get_std_unique_ptr() <= rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return rhs < lhs
+ */
+template <class T1, class D1, class P1, class T2, class D2, class P2>
+bool operator>(const unique_ptr<T1, D1, P1> &lhs,
+               const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs.get_std_unique_ptr() > rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return !(lhs < rhs)
+ */
+template <class T1, class D1, class P1, class T2, class D2, class P2>
+bool operator>=(const unique_ptr<T1, D1, P1> &lhs,
+                const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs.get_std_unique_ptr() >= rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return lhs.get() == rhs.get()
+ */
+template <class T1, class D1, class T2, class D2, class P2>
+bool operator==(const std::unique_ptr<T1, D1> &lhs,
+                const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs == rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return !(lhs.get() == rhs.get())
+ */
+template <class T1, class D1, class T2, class D2, class P2>
+bool operator!=(const std::unique_ptr<T1, D1> &lhs,
+                const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs != rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return std::less<CT>()(lhs.get(), rhs.get()),  where CT is
+ * std::common_type<unique_ptr<T1, D1>::pointer,
+ *  unique_ptr<T2,D2>::pointer>::type
+ */
+template <class T1, class D1, class T2, class D2, class P2>
+bool operator<(const std::unique_ptr<T1, D1> &lhs,
+               const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs < rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return !(rhs < lhs)
+ */
+template <class T1, class D1, class T2, class D2, class P2>
+bool operator<=(const std::unique_ptr<T1, D1> &lhs,
+                const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs <= rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return rhs < lhs
+ */
+template <class T1, class D1, class T2, class D2, class P2>
+bool operator>(const std::unique_ptr<T1, D1> &lhs,
+               const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs > rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return !(lhs < rhs)
+ */
+template <class T1, class D1, class T2, class D2, class P2>
+bool operator>=(const std::unique_ptr<T1, D1> &lhs,
+                const unique_ptr<T2, D2, P2> &rhs) {
+    return lhs >= rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return lhs.get() == rhs.get()
+ */
+template <class T1, class D1, class P1, class T2, class D2>
+bool operator==(const unique_ptr<T1, D1, P1> &lhs,
+                const std::unique_ptr<T2, D2> &rhs) {
+    return lhs.get_std_unique_ptr() == rhs;
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return !(lhs.get() == rhs.get())
+ */
+template <class T1, class D1, class P1, class T2, class D2>
+bool operator!=(const unique_ptr<T1, D1, P1> &lhs,
+                const std::unique_ptr<T2, D2> &rhs) {
+    return lhs.get_std_unique_ptr() != rhs;
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return std::less<CT>()(lhs.get(), rhs.get()),  where CT is
+ * std::common_type<unique_ptr<T1, D1>::pointer,
+ * unique_ptr<T2,D2>::pointer>::type
+ */
+template <class T1, class D1, class P1, class T2, class D2>
+bool operator<(const unique_ptr<T1, D1, P1> &lhs,
+               const std::unique_ptr<T2, D2> &rhs) {
+    return lhs.get_std_unique_ptr() < rhs;
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return !(rhs < lhs)
+ */
+template <class T1, class D1, class P1, class T2, class D2>
+bool operator<=(const unique_ptr<T1, D1, P1> &lhs,
+                const std::unique_ptr<T2, D2> &rhs) {
+    return lhs.get_std_unique_ptr() <= rhs;
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return rhs < lhs
+ */
+template <class T1, class D1, class P1, class T2, class D2>
+bool operator>(const unique_ptr<T1, D1, P1> &lhs,
+               const std::unique_ptr<T2, D2> &rhs) {
+    return lhs.get_std_unique_ptr() > rhs;
+}
+
+/** \brief Compare two unique_ptr objects
+ * \return !(lhs < rhs)
+ */
+template <class T1, class D1, class P1, class T2, class D2>
+bool operator>=(const unique_ptr<T1, D1, P1> &lhs,
+                const std::unique_ptr<T2, D2> &rhs) {
+    return lhs.get_std_unique_ptr() >= rhs;
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return !lhs
+ */
+template <class T, class D, class P>
+bool operator==(const unique_ptr<T, D, P> &lhs,
+                std::nullptr_t rhs) TSP_NOEXCEPT {
+    return lhs.get_std_unique_ptr() == rhs;
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return !rhs
+ */
+template <class T, class D, class P>
+bool operator==(std::nullptr_t lhs,
+                const unique_ptr<T, D, P> &rhs) TSP_NOEXCEPT {
+    return lhs == rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return (bool)lhs
+ */
+template <class T, class D, class P>
+bool operator!=(const unique_ptr<T, D, P> &lhs,
+                std::nullptr_t rhs) TSP_NOEXCEPT {
+    return lhs.get_std_unique_ptr() != rhs;
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return (bool)rhs
+ */
+template <class T, class D, class P>
+bool operator!=(std::nullptr_t lhs,
+                const unique_ptr<T, D, P> &rhs) TSP_NOEXCEPT {
+    return lhs != rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return std::less<unique_ptr<T,D>::pointer>()(lhs.get(), nullptr)
+ */
+template <class T, class D, class P>
+bool operator<(const unique_ptr<T, D, P> &lhs, std::nullptr_t rhs) {
+    return lhs.get_std_unique_ptr() < rhs;
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return std::less<unique_ptr<T,D>::pointer>()(nullptr, rhs.get())
+ */
+template <class T, class D, class P>
+bool operator<(std::nullptr_t lhs, const unique_ptr<T, D, P> &rhs) {
+    return lhs < rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return !(nullptr < lhs)
+ */
+template <class T, class D, class P>
+bool operator<=(const unique_ptr<T, D, P> &lhs, std::nullptr_t rhs) {
+    return lhs.get_std_unique_ptr() <= rhs;
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return !(rhs < nullptr)
+ */
+template <class T, class D, class P>
+bool operator<=(std::nullptr_t lhs, const unique_ptr<T, D, P> &rhs) {
+    return lhs <= rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return nullptr < lhs
+ */
+template <class T, class D, class P>
+bool operator>(const unique_ptr<T, D, P> &lhs, std::nullptr_t rhs) {
+    return lhs.get_std_unique_ptr() > rhs;
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return rhs < nullptr
+ */
+template <class T, class D, class P>
+bool operator>(std::nullptr_t lhs, const unique_ptr<T, D, P> &rhs) {
+    return lhs > rhs.get_std_unique_ptr();
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return !(lhs < nullptr)
+ */
+template <class T, class D, class P>
+bool operator>=(const unique_ptr<T, D, P> &lhs, std::nullptr_t rhs) {
+    return lhs.get_std_unique_ptr() >= rhs;
+}
+
+/** \brief Compare a unique_ptr with a null pointer
+ * \return !(nullptr < rhs)
+ */
+template <class T, class D, class P>
+bool operator>=(std::nullptr_t lhs, const unique_ptr<T, D, P> &rhs) {
+    return lhs >= rhs.get_std_unique_ptr();
+}
+
+/** \brief Specializes the std::swap algorithm for throwing::unique_ptr.
+ *
+ * Swaps the pointers of lhs and rhs.
+ *
+ * Calls lhs.swap(rhs).
+ *
+ * This function does not participate in overload resolution unless
+ * std::is_swappable<D>::value is true. (since C++17)
+ */
+template <class T, class D, class P>
+void swap(throwing::unique_ptr<T, D, P> &lhs,
+          throwing::unique_ptr<T, D, P> &rhs) TSP_NOEXCEPT {
+    std::swap(lhs.get_std_unique_ptr(), rhs.get_std_unique_ptr());
+}
+
+} // namespace throwing
+
+#include <throwing/private/clear_compiler_checks.hpp>
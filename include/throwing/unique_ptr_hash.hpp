@@ -0,0 +1,36 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+/** \file throwing/unique_ptr_hash.hpp
+ * \brief Specialization of std::hash for throwing::unique_ptr
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <throwing/unique_ptr_core.hpp>
+
+namespace std {
+
+/** \brief Template specialization of std::hash for throwing::unique_ptr<T>
+ *
+ * When enabled, (since C++17) for a given throwing::unique_ptr<T, D> p, this
+ * specialization ensures that std::hash<throwing::unique_ptr<T, D>>()(p) ==
+ * std::hash<typename throwing::unique_ptr<T, D>::pointer>()(p.get())
+ *
+ * The specialization std::hash<throwing::unique_ptr<T,D>> is enabled (see
+ * std::hash) if std::hash<typename throwing::unique_ptr<T,D>::pointer> is
+ * enabled, and is disabled otherwise. (since C++17)
+ */
+template <typename Type, typename Deleter, typename NullPolicy>
+struct hash<throwing::unique_ptr<Type, Deleter, NullPolicy>> {
+    size_t operator()(
+            const throwing::unique_ptr<Type, Deleter, NullPolicy> &x) const {
+        return std::hash<typename throwing::unique_ptr<
+                Type, Deleter, NullPolicy>::std_unique_ptr_type>()(
+                x.get_std_unique_ptr());
+    }
+};
+
+} // namespace std
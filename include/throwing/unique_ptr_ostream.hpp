@@ -0,0 +1,29 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+/** \file throwing/unique_ptr_ostream.hpp
+ * \brief Stream insertion of throwing::unique_ptr
+ */
+
+#pragma once
+#include <iosfwd>
+#include <throwing/unique_ptr_core.hpp>
+
+namespace throwing {
+
+/** \brief Inserts the value of the pointer stored in ptr into the output stream
+ * os
+ *
+ * Equivalent to os << ptr.get().
+ * \return os
+ */
+template <class CharT, class Traits, class Y, class D, class P>
+std::basic_ostream<CharT, Traits> &
+operator<<(std::basic_ostream<CharT, Traits> &os,
+           const unique_ptr<Y, D, P> &ptr) {
+    os << ptr.get();
+    return os;
+}
+
+} // namespace throwing
@@ -0,0 +1,103 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+/** \file throwing.cppm
+ * \brief Interface unit of the throwing module
+ *
+ * Exports the public entities of throwing/shared_ptr.hpp,
+ * throwing/atomic_shared_ptr.hpp, throwing/atomic_weak_ptr.hpp,
+ * throwing/local_shared_ptr.hpp, throwing/unique_ptr.hpp,
+ * throwing/not_null.hpp and throwing/telemetry.hpp, which stay usable as
+ * headers. The headers are parsed once, when the module
+ * is built, instead of once per translation unit:
+ *
+ *     import throwing;
+ *
+ *     throwing::shared_ptr<int> p = throwing::make_shared<int>(42);
+ *
+ * Configuration macros, such as THROWING_PTR_TELEMETRY or
+ * THROWING_PTR_BACKTRACE, must be defined when building the module and are
+ * not visible to importers. Macros, such as THROWING_PTR_EXTERN_TEMPLATES,
+ * are not exported; include the header that defines them.
+ */
+
+module;
+
+#include <throwing/atomic_shared_ptr.hpp>
+#include <throwing/atomic_weak_ptr.hpp>
+#include <throwing/local_shared_ptr.hpp>
+#include <throwing/not_null.hpp>
+#include <throwing/shared_ptr.hpp>
+#include <throwing/telemetry.hpp>
+#include <throwing/unique_ptr.hpp>
+
+export module throwing;
+
+export namespace throwing {
+
+// Smart pointers
+using throwing::enable_shared_from_this;
+using throwing::local_shared_ptr;
+using throwing::local_weak_ptr;
+using throwing::not_null;
+using throwing::shared_ptr;
+using throwing::unique_ptr;
+using throwing::weak_ptr;
+
+// Creation and casts
+using throwing::allocate_shared;
+using throwing::const_pointer_cast;
+using throwing::dynamic_pointer_cast;
+using throwing::get_deleter;
+using throwing::make_local_shared;
+using throwing::make_shared;
+using throwing::make_unique;
+using throwing::reinterpret_pointer_cast;
+using throwing::static_pointer_cast;
+
+// Operators and swap, also found by argument-dependent lookup
+using throwing::operator==;
+using throwing::operator!=;
+using throwing::operator<;
+using throwing::operator>;
+using throwing::operator<=;
+using throwing::operator>=;
+using throwing::operator<<;
+using throwing::swap;
+
+// Atomic access to shared_ptr and weak_ptr
+using throwing::atomic_shared_ptr;
+using throwing::atomic_weak_ptr;
+using throwing::atomic_compare_exchange_strong;
+using throwing::atomic_compare_exchange_strong_explicit;
+using throwing::atomic_compare_exchange_weak;
+using throwing::atomic_compare_exchange_weak_explicit;
+using throwing::atomic_exchange;
+using throwing::atomic_exchange_explicit;
+using throwing::atomic_is_lock_free;
+using throwing::atomic_load;
+using throwing::atomic_load_explicit;
+using throwing::atomic_store;
+using throwing::atomic_store_explicit;
+
+// Null dereferences
+using throwing::base_null_ptr_exception;
+using throwing::callback_on_null;
+using throwing::deref_result;
+using throwing::get_null_handler;
+using throwing::null_handler;
+using throwing::null_ptr_exception;
+using throwing::set_null_handler;
+using throwing::source_location;
+using throwing::terminate_on_null;
+using throwing::throw_on_null;
+using throwing::unchecked_on_null;
+
+// Telemetry
+using throwing::for_each_null_dereference_count;
+using throwing::null_dereference_count;
+using throwing::null_dereference_counts;
+
+} // namespace throwing
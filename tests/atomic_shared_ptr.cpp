@@ -0,0 +1,176 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <catch.hpp>
+#include <thread>
+#include <throwing/atomic_shared_ptr.hpp>
+#include <throwing/shared_ptr.hpp>
+#include <vector>
+
+TEST_CASE("atomic_shared_ptr default constructed holds an empty pointer",
+          "[atomic_shared_ptr]") {
+    throwing::atomic_shared_ptr<int> a;
+    REQUIRE(a.load() == nullptr);
+    throwing::atomic_shared_ptr<int> b(nullptr);
+    REQUIRE(b.load() == nullptr);
+}
+
+TEST_CASE("atomic_shared_ptr is lock free", "[atomic_shared_ptr]") {
+    throwing::atomic_shared_ptr<int> a;
+    REQUIRE(a.is_lock_free());
+}
+
+TEST_CASE("atomic_shared_ptr load shares ownership with the stored pointer",
+          "[atomic_shared_ptr]") {
+    const auto p = throwing::make_shared<int>(42);
+    throwing::atomic_shared_ptr<int> a(p);
+    REQUIRE(p.use_count() == 2);
+    {
+        throwing::shared_ptr<int> loaded = a.load();
+        REQUIRE(loaded == p);
+        REQUIRE(*loaded == 42);
+        REQUIRE(p.use_count() == 3);
+    }
+    const throwing::shared_ptr<int> converted = a;
+    REQUIRE(converted == p);
+}
+
+TEST_CASE("atomic_shared_ptr releases the held pointer on destruction",
+          "[atomic_shared_ptr]") {
+    const auto p = throwing::make_shared<int>(42);
+    {
+        throwing::atomic_shared_ptr<int> a(p);
+        REQUIRE(p.use_count() == 2);
+        a.load();
+    }
+    REQUIRE(p.use_count() == 1);
+}
+
+TEST_CASE("atomic_shared_ptr store and exchange replace the held pointer",
+          "[atomic_shared_ptr]") {
+    const auto p1 = throwing::make_shared<int>(1);
+    const auto p2 = throwing::make_shared<int>(2);
+    throwing::atomic_shared_ptr<int> a(p1);
+
+    a.store(p2, std::memory_order_release);
+    REQUIRE(p1.use_count() == 1);
+    REQUIRE(a.load(std::memory_order_acquire) == p2);
+
+    auto previous = a.exchange(p1);
+    REQUIRE(previous == p2);
+    REQUIRE(a.load() == p1);
+
+    a = nullptr;
+    REQUIRE(a.load() == nullptr);
+    REQUIRE(p1.use_count() == 1);
+    a = p2;
+    REQUIRE(*a.load() == 2);
+}
+
+TEST_CASE("atomic_shared_ptr compare_exchange_strong compares pointers, not "
+          "values",
+          "[atomic_shared_ptr]") {
+    const auto p = throwing::make_shared<int>(1);
+    throwing::atomic_shared_ptr<int> a(p);
+    auto expected = throwing::make_shared<int>(1);
+    const auto desired = throwing::make_shared<int>(2);
+
+    REQUIRE_FALSE(a.compare_exchange_strong(expected, desired));
+    REQUIRE(expected == p);
+    REQUIRE(a.load() == p);
+    REQUIRE(desired.use_count() == 1);
+
+    REQUIRE(a.compare_exchange_strong(expected, desired,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_acquire));
+    REQUIRE(a.load() == desired);
+    REQUIRE(p.use_count() == 2);
+}
+
+TEST_CASE("atomic_shared_ptr compare_exchange_weak compares ownership",
+          "[atomic_shared_ptr]") {
+    const auto owner = throwing::make_shared<int>(1);
+    // Same stored pointer, no ownership
+    throwing::shared_ptr<int> alias(throwing::shared_ptr<int>(), owner.get());
+    throwing::atomic_shared_ptr<int> a(owner);
+    const auto desired = throwing::make_shared<int>(2);
+
+    REQUIRE_FALSE(a.compare_exchange_weak(alias, desired));
+    REQUIRE(alias == owner);
+    REQUIRE(alias.use_count() == owner.use_count());
+    REQUIRE(a.compare_exchange_weak(alias, desired));
+    REQUIRE(a.load() == desired);
+}
+
+TEST_CASE("atomic_shared_ptr compare_exchange works on empty pointers",
+          "[atomic_shared_ptr]") {
+    throwing::atomic_shared_ptr<int> a;
+    throwing::shared_ptr<int> expected;
+    const auto desired = throwing::make_shared<int>(1);
+
+    REQUIRE(a.compare_exchange_strong(expected, desired));
+    REQUIRE(a.load() == desired);
+    REQUIRE_FALSE(a.compare_exchange_strong(expected, nullptr));
+    REQUIRE(expected == desired);
+    REQUIRE(a.compare_exchange_strong(expected, nullptr));
+    REQUIRE(a.load() == nullptr);
+    REQUIRE(desired.use_count() == 2);
+}
+
+TEST_CASE("atomic_shared_ptr keeps a consistent count under contention",
+          "[atomic_shared_ptr]") {
+    const int threads = 4;
+    const int iterations = 20000;
+    const auto first = throwing::make_shared<int>(0);
+    throwing::atomic_shared_ptr<int> a(first);
+    std::atomic<bool> bad_value(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < iterations; ++i) {
+                switch ((i + t) % 4) {
+                case 0:
+                    if (*a.load() < 0)
+                        bad_value = true;
+                    break;
+                case 1:
+                    a.store(throwing::make_shared<int>(i));
+                    break;
+                case 2:
+                    if (*a.exchange(throwing::make_shared<int>(i)) < 0)
+                        bad_value = true;
+                    break;
+                default: {
+                    auto expected = a.load();
+                    a.compare_exchange_weak(
+                            expected, throwing::make_shared<int>(*expected));
+                } break;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    REQUIRE_FALSE(bad_value);
+    REQUIRE(first.use_count() == 1);
+    REQUIRE(a.load().use_count() == 2);
+}
+
+TEST_CASE("atomic_shared_ptr wait returns once the pointer changes",
+          "[atomic_shared_ptr]") {
+    const auto p1 = throwing::make_shared<int>(1);
+    const auto p2 = throwing::make_shared<int>(2);
+    throwing::atomic_shared_ptr<int> a(p1);
+
+    // Returns at once when the held pointer already differs
+    a.wait(p2);
+
+    std::thread waiter([&] { a.wait(p1); });
+    a.store(p2);
+    a.notify_all();
+    waiter.join();
+    REQUIRE(a.load() == p2);
+}
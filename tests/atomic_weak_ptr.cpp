@@ -0,0 +1,115 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <catch.hpp>
+#include <thread>
+#include <throwing/atomic_weak_ptr.hpp>
+#include <throwing/shared_ptr.hpp>
+#include <vector>
+
+TEST_CASE("atomic_weak_ptr default constructed holds an empty pointer",
+          "[atomic_weak_ptr]") {
+    throwing::atomic_weak_ptr<int> a;
+    REQUIRE(a.is_lock_free());
+    REQUIRE(a.load().expired());
+    REQUIRE(a.lock() == nullptr);
+}
+
+TEST_CASE("atomic_weak_ptr does not own the object", "[atomic_weak_ptr]") {
+    auto p = throwing::make_shared<int>(42);
+    throwing::atomic_weak_ptr<int> a(p);
+    REQUIRE(p.use_count() == 1);
+    REQUIRE(*a.lock() == 42);
+    REQUIRE(a.load().lock() == p);
+    const throwing::weak_ptr<int> converted = a;
+    REQUIRE(converted.lock() == p);
+
+    p.reset();
+    REQUIRE(a.lock() == nullptr);
+    REQUIRE(a.load().expired());
+}
+
+TEST_CASE("atomic_weak_ptr store and exchange replace the held pointer",
+          "[atomic_weak_ptr]") {
+    const auto p1 = throwing::make_shared<int>(1);
+    const auto p2 = throwing::make_shared<int>(2);
+    throwing::atomic_weak_ptr<int> a(p1);
+
+    a.store(p2, std::memory_order_release);
+    REQUIRE(a.lock(std::memory_order_acquire) == p2);
+    const auto previous = a.exchange(p1);
+    REQUIRE(previous.lock() == p2);
+    a = p2;
+    REQUIRE(a.load().lock() == p2);
+    a.store(throwing::weak_ptr<int>());
+    REQUIRE(a.lock() == nullptr);
+}
+
+TEST_CASE("atomic_weak_ptr compare_exchange compares ownership",
+          "[atomic_weak_ptr]") {
+    const auto p1 = throwing::make_shared<int>(1);
+    const auto p2 = throwing::make_shared<int>(2);
+    throwing::atomic_weak_ptr<int> a(p1);
+    throwing::weak_ptr<int> expected(p2);
+
+    REQUIRE_FALSE(a.compare_exchange_strong(expected, p2));
+    REQUIRE(expected.lock() == p1);
+    REQUIRE(a.compare_exchange_weak(expected, p2));
+    REQUIRE(a.lock() == p2);
+
+    // An expired weak pointer still matches itself
+    auto temporary = throwing::make_shared<int>(3);
+    a.store(temporary);
+    throwing::weak_ptr<int> expired(temporary);
+    temporary.reset();
+    REQUIRE(a.compare_exchange_strong(expired, p1));
+    REQUIRE(a.lock() == p1);
+}
+
+TEST_CASE("atomic_weak_ptr lock races with the last owner",
+          "[atomic_weak_ptr]") {
+    // Writers publish weak references to objects they own only briefly while
+    // readers lock them: every lock must give an empty pointer or a live
+    // object.
+    const int threads = 4;
+    const int iterations = 20000;
+    throwing::atomic_weak_ptr<int> a;
+    std::atomic<bool> bad_value(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < iterations; ++i) {
+                if ((i + t) % 2 == 0) {
+                    const auto owner = throwing::make_shared<int>(i);
+                    a.store(owner);
+                    if (*owner != i)
+                        bad_value = true;
+                } else {
+                    const auto p = a.lock();
+                    if (p != nullptr && (*p < 0 || *p >= iterations))
+                        bad_value = true;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    REQUIRE_FALSE(bad_value);
+    REQUIRE(a.lock() == nullptr);
+}
+
+TEST_CASE("atomic_weak_ptr wait returns once the pointer changes",
+          "[atomic_weak_ptr]") {
+    const auto p1 = throwing::make_shared<int>(1);
+    const auto p2 = throwing::make_shared<int>(2);
+    throwing::atomic_weak_ptr<int> a(p1);
+
+    std::thread waiter([&] { a.wait(p1); });
+    a.store(p2);
+    a.notify_one();
+    waiter.join();
+    REQUIRE(a.lock() == p2);
+}
@@ -0,0 +1,108 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Behaviour of the smart pointers when an allocation throws std::bad_alloc.
+// This file replaces the global operator new, so it is built in its own
+// executable.
+
+#include <catch.hpp>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <throwing/atomic_shared_ptr.hpp>
+#include <throwing/local_shared_ptr.hpp>
+
+namespace {
+
+/** \brief Makes the replacement operator new below throw std::bad_alloc */
+bool fail_allocations = false;
+
+struct Counted {
+    explicit Counted(int &alive) : alive(alive) { ++alive; }
+    ~Counted() { --alive; }
+    int &alive;
+};
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    if (!fail_allocations) {
+        if (void *p = std::malloc(size ? size : 1))
+            return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return fail_allocations ? nullptr : std::malloc(size ? size : 1);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    std::free(p);
+}
+
+TEST_CASE("local_shared_ptr constructors release the pointer once on "
+          "bad_alloc",
+          "[local_shared_ptr][construction][bad_alloc]") {
+    int alive = 0;
+    Counted *raw = new Counted(alive);
+    std::unique_ptr<Counted> unique(new Counted(alive));
+    REQUIRE(alive == 2);
+
+    bool raw_threw = false;
+    bool unique_threw = false;
+    fail_allocations = true;
+    try {
+        throwing::local_shared_ptr<Counted> p(raw);
+    } catch (const std::bad_alloc &) {
+        raw_threw = true;
+    }
+    try {
+        throwing::local_shared_ptr<Counted> p(std::move(unique));
+    } catch (const std::bad_alloc &) {
+        unique_threw = true;
+    }
+    fail_allocations = false;
+
+    // The raw pointer is deleted, the unique_ptr keeps ownership
+    REQUIRE(raw_threw);
+    REQUIRE(unique_threw);
+    REQUIRE(alive == 1);
+    REQUIRE(unique);
+    unique.reset();
+    REQUIRE(alive == 0);
+}
+
+TEST_CASE("atomic_shared_ptr compare_exchange keeps its value on bad_alloc",
+          "[atomic_shared_ptr][bad_alloc]") {
+    int alive = 0;
+    {
+        throwing::atomic_shared_ptr<Counted> a(
+                throwing::make_shared<Counted>(alive));
+        throwing::shared_ptr<Counted> expected = a.load();
+        throwing::shared_ptr<Counted> desired =
+                throwing::make_shared<Counted>(alive);
+
+        bool threw = false;
+        fail_allocations = true;
+        try {
+            a.compare_exchange_strong(expected, desired);
+        } catch (const std::bad_alloc &) {
+            threw = true;
+        }
+        fail_allocations = false;
+
+        REQUIRE(threw);
+        REQUIRE(a.load() == expected);
+        REQUIRE(a.compare_exchange_strong(expected, desired));
+        REQUIRE(a.load() == desired);
+    }
+    // No node was leaked with its pointer
+    REQUIRE(alive == 0);
+}
@@ -0,0 +1,16 @@
+# Runs PROGRAM with the default_handler argument and checks that it terminates
+# unsuccessfully after logging the type of the null pointer to stderr.
+#
+# Usage: cmake -DPROGRAM=<path> -P check_default_null_handler.cmake
+
+execute_process(COMMAND ${PROGRAM} default_handler
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error)
+
+if(result EQUAL 0)
+    message(FATAL_ERROR "${PROGRAM} exited successfully, expected an abort")
+endif()
+if(NOT error MATCHES "Dereferenced nullptr of type")
+    message(FATAL_ERROR "Unexpected output from ${PROGRAM}: ${error}")
+endif()
+message(STATUS "${PROGRAM} terminated with: ${result}")
@@ -0,0 +1,16 @@
+# Runs PROGRAM and checks that it terminates unsuccessfully after failing the
+# assertion that a local_shared_ptr is only used by the thread that created it.
+#
+# Usage: cmake -DPROGRAM=<path> -P check_local_shared_ptr_thread.cmake
+
+execute_process(COMMAND ${PROGRAM}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error)
+
+if(result EQUAL 0)
+    message(FATAL_ERROR "${PROGRAM} exited successfully, expected an abort")
+endif()
+if(NOT error MATCHES "local_shared_ptr used from a thread other than its creator")
+    message(FATAL_ERROR "Unexpected output from ${PROGRAM}: ${error}")
+endif()
+message(STATUS "${PROGRAM} terminated with: ${result}")
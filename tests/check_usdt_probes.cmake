@@ -0,0 +1,44 @@
+#          Copyright Claudio Bantaloukas 2017-2018.
+# Distributed under the Boost Software License, Version 1.0.
+#    (See accompanying file LICENSE or copy at
+#          http://www.boost.org/LICENSE_1_0.txt)
+
+# Runs PROGRAM, then checks that the SystemTap notes of PROGRAM describe each
+# of the throwing_ptr USDT probes.
+#
+# Usage: cmake -DREADELF=<readelf> -DPROGRAM=<path> -P check_usdt_probes.cmake
+
+foreach(var READELF PROGRAM)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "${var} must be defined")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${PROGRAM} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${PROGRAM} failed with: ${result}")
+endif()
+
+execute_process(COMMAND ${READELF} --notes ${PROGRAM}
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE notes)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${READELF} failed with: ${result}")
+endif()
+
+set(PROBES
+    null_dereference
+    make_shared
+    allocate_shared
+    make_unique
+    atomic_load
+    atomic_store
+    atomic_exchange
+    atomic_compare_exchange
+)
+foreach(probe ${PROBES})
+    if(NOT notes MATCHES "Provider: throwing_ptr[\r\n\t ]+Name: ${probe}[\r\n]")
+        message(FATAL_ERROR "USDT probe throwing_ptr:${probe} not found")
+    endif()
+    message(STATUS "Found USDT probe throwing_ptr:${probe}")
+endforeach()
@@ -0,0 +1,83 @@
+#          Copyright Claudio Bantaloukas 2017-2018.
+# Distributed under the Boost Software License, Version 1.0.
+#    (See accompanying file LICENSE or copy at
+#          http://www.boost.org/LICENSE_1_0.txt)
+
+# Measures the code generated for each probe_throwing_* function in LIBRARY
+# and compares it with its probe_std_* counterpart. The size of a probe
+# includes any .cold partition the compiler split off the function.
+# Probes named probe_throwing_unchecked_* must not be larger than their
+# counterpart, probes named probe_throwing_located_* must stay within
+# BUDGET + LOCATION_BUDGET bytes of it and the others within BUDGET bytes.
+#
+# Usage: cmake -DNM=<nm> -DLIBRARY=<archive> -DBUDGET=<bytes>
+#              -DLOCATION_BUDGET=<bytes> -P <this file>
+
+foreach(var NM LIBRARY BUDGET LOCATION_BUDGET)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "${var} must be defined")
+    endif()
+endforeach()
+
+function(hex_to_decimal hex result)
+    string(TOLOWER "${hex}" hex)
+    set(value 0)
+    string(LENGTH "${hex}" length)
+    math(EXPR last "${length} - 1")
+    foreach(i RANGE ${last})
+        string(SUBSTRING "${hex}" ${i} 1 digit)
+        string(FIND "0123456789abcdef" "${digit}" digit_value)
+        math(EXPR value "${value} * 16 + ${digit_value}")
+    endforeach()
+    set(${result} ${value} PARENT_SCOPE)
+endfunction()
+
+execute_process(COMMAND ${NM} --print-size ${LIBRARY}
+    OUTPUT_VARIABLE symbols
+    RESULT_VARIABLE nm_result)
+if(NOT nm_result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${LIBRARY}")
+endif()
+
+string(REPLACE "\n" ";" lines "${symbols}")
+set(probes)
+foreach(line ${lines})
+    if(line MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) [tT] (probe_[a-z_]+)(\\.cold[.0-9]*)?$")
+        set(name ${CMAKE_MATCH_2})
+        hex_to_decimal(${CMAKE_MATCH_1} size)
+        if(NOT DEFINED size_${name})
+            set(size_${name} 0)
+            list(APPEND probes ${name})
+        endif()
+        math(EXPR size_${name} "${size_${name}} + ${size}")
+    endif()
+endforeach()
+
+set(checked 0)
+foreach(name ${probes})
+    if(name MATCHES "^probe_throwing_(.*)$")
+        set(std_name probe_std_${CMAKE_MATCH_1})
+        if(NOT DEFINED size_${std_name})
+            message(FATAL_ERROR "${name} has no ${std_name} counterpart")
+        endif()
+        math(EXPR overhead "${size_${name}} - ${size_${std_name}}")
+        message(STATUS "${CMAKE_MATCH_1}: ${size_${name}} bytes, "
+            "std ${size_${std_name}} bytes, overhead ${overhead} bytes")
+        if(name MATCHES "^probe_throwing_unchecked_")
+            set(budget 0)
+        elseif(name MATCHES "^probe_throwing_located_")
+            math(EXPR budget "${BUDGET} + ${LOCATION_BUDGET}")
+        else()
+            set(budget ${BUDGET})
+        endif()
+        if(overhead GREATER budget)
+            message(SEND_ERROR "${name} exceeds the budget of ${budget} "
+                "bytes over ${std_name}")
+        endif()
+        math(EXPR checked "${checked} + 1")
+    endif()
+endforeach()
+
+if(checked EQUAL 0)
+    message(FATAL_ERROR "no probes found in ${LIBRARY}")
+endif()
@@ -0,0 +1,45 @@
+#          Copyright Claudio Bantaloukas 2017-2018.
+# Distributed under the Boost Software License, Version 1.0.
+#    (See accompanying file LICENSE or copy at
+#          http://www.boost.org/LICENSE_1_0.txt)
+
+# Checks that LIBRARY defines no symbol of a throwing template specialized
+# for ExternWidget, whose templates are declared with
+# THROWING_PTR_EXTERN_TEMPLATES, while it does define them for
+# ImplicitWidget, which shows that the probes instantiate them.
+# Destructors are ignored: they are implicitly defined, and explicit
+# instantiation declarations do not keep the compiler from emitting implicitly
+# defined member functions where they are used.
+#
+# Usage: cmake -DNM=<nm> -DLIBRARY=<archive> -P <this file>
+
+foreach(var NM LIBRARY)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "${var} must be defined")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${NM} --defined-only -C ${LIBRARY}
+    OUTPUT_VARIABLE symbols
+    RESULT_VARIABLE nm_result)
+if(NOT nm_result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${LIBRARY}")
+endif()
+
+string(REPLACE "\n" ";" lines "${symbols}")
+set(implicit 0)
+foreach(line ${lines})
+    if(line MATCHES "::~[a-z_]+\\(\\)$")
+        continue()
+    elseif(line MATCHES "throwing::[a-z_:]+<ExternWidget")
+        message(SEND_ERROR "instantiated despite extern template: ${line}")
+    elseif(line MATCHES "throwing::[a-z_:]+<ImplicitWidget")
+        math(EXPR implicit "${implicit} + 1")
+    endif()
+endforeach()
+
+if(implicit EQUAL 0)
+    message(FATAL_ERROR "no symbol instantiated for ImplicitWidget")
+endif()
+message(STATUS "${implicit} symbols instantiated for ImplicitWidget, "
+    "none for ExternWidget")
@@ -0,0 +1,108 @@
+#          Copyright Claudio Bantaloukas 2017-2018.
+# Distributed under the Boost Software License, Version 1.0.
+#    (See accompanying file LICENSE or copy at
+#          http://www.boost.org/LICENSE_1_0.txt)
+
+# Disassembles LIBRARY and compares the fast path of each probe_throwing_*
+# function with the fast path of its probe_std_* counterpart. The fast path
+# runs from the entry point to the first return or unconditional jump, which
+# is the path taken when the pointer is not null since the null checks are
+# marked unlikely. Padding nops are not counted.
+#
+# The fast path of a throwing probe must not contain more calls than its
+# counterpart, so that an outlined constructor or helper fails the test. It
+# must not be longer than its counterpart by more than INSTRUCTION_BUDGET
+# instructions, or by any instruction for probe_throwing_unchecked_* probes.
+#
+# Supports x86 and AArch64 disassembly.
+#
+# Usage: cmake -DOBJDUMP=<objdump> -DLIBRARY=<archive>
+#              -DINSTRUCTION_BUDGET=<instructions> -P <this file>
+
+foreach(var OBJDUMP LIBRARY INSTRUCTION_BUDGET)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "${var} must be defined")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${OBJDUMP} -d --no-show-raw-insn ${LIBRARY}
+    OUTPUT_VARIABLE disassembly
+    RESULT_VARIABLE objdump_result)
+if(NOT objdump_result EQUAL 0)
+    message(FATAL_ERROR "${OBJDUMP} failed on ${LIBRARY}")
+endif()
+
+# Keep CMake list handling away from the characters it interprets
+string(REPLACE ";" "," disassembly "${disassembly}")
+string(REPLACE "[" "(" disassembly "${disassembly}")
+string(REPLACE "]" ")" disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+
+set(probes)
+set(current "")
+foreach(line ${lines})
+    if(line MATCHES "^[0-9a-fA-F]+ <([^>]*)>:$")
+        set(current "")
+        set(symbol ${CMAKE_MATCH_1})
+        if(symbol MATCHES "^probe_[a-z_]+$")
+            set(current ${symbol})
+            set(instructions_${current} 0)
+            set(calls_${current} 0)
+            set(done_${current} FALSE)
+            list(APPEND probes ${current})
+        endif()
+    elseif(current AND NOT done_${current}
+            AND line MATCHES "^ *[0-9a-fA-F]+:\t(.*)$")
+        string(STRIP "${CMAKE_MATCH_1}" instruction)
+        string(REGEX REPLACE
+            "^((rep|repz|bnd|notrack|lock|data16|cs|ds) +)+" ""
+            instruction "${instruction}")
+        string(REGEX MATCH "^[^ \t]+" mnemonic "${instruction}")
+        if(mnemonic MATCHES "^nop")
+            continue()
+        endif()
+        math(EXPR instructions_${current} "${instructions_${current}} + 1")
+        if(mnemonic MATCHES "^(call|callq|bl|blr)$")
+            math(EXPR calls_${current} "${calls_${current}} + 1")
+        elseif(mnemonic MATCHES "^(jmp|jmpq|b|br)$")
+            # A tail call, or a jump leaving the fast path
+            math(EXPR calls_${current} "${calls_${current}} + 1")
+            set(done_${current} TRUE)
+        elseif(mnemonic MATCHES "^(ret|retq)$")
+            set(done_${current} TRUE)
+        endif()
+    endif()
+endforeach()
+
+set(checked 0)
+foreach(name ${probes})
+    if(name MATCHES "^probe_throwing_(.*)$")
+        set(std_name probe_std_${CMAKE_MATCH_1})
+        if(NOT DEFINED instructions_${std_name})
+            message(FATAL_ERROR "${name} has no ${std_name} counterpart")
+        endif()
+        message(STATUS "${CMAKE_MATCH_1}: "
+            "${instructions_${name}} instructions, "
+            "${calls_${name}} calls, std ${instructions_${std_name}} "
+            "instructions, ${calls_${std_name}} calls")
+        if(name MATCHES "^probe_throwing_unchecked_")
+            set(budget 0)
+        else()
+            set(budget ${INSTRUCTION_BUDGET})
+        endif()
+        math(EXPR limit "${instructions_${std_name}} + ${budget}")
+        if(instructions_${name} GREATER limit)
+            message(SEND_ERROR "the fast path of ${name} exceeds the budget "
+                "of ${budget} instructions over ${std_name}")
+        endif()
+        if(calls_${name} GREATER calls_${std_name})
+            message(SEND_ERROR "the fast path of ${name} makes more calls "
+                "than ${std_name}")
+        endif()
+        math(EXPR checked "${checked} + 1")
+    endif()
+endforeach()
+
+if(checked EQUAL 0)
+    message(FATAL_ERROR "no probes found in ${LIBRARY}")
+endif()
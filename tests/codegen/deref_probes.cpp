@@ -0,0 +1,221 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Probe functions used to measure the code generated for each checked
+// dereference operator. Every probe_throwing_* function has a probe_std_*
+// counterpart performing the same access through the std smart pointer;
+// check_code_size.cmake compares their sizes. The probe_*_unchecked_* probes
+// use the unchecked accessors, which must not add any code. The
+// probe_*_located_* probes capture the call site, which adds the setup of the
+// location arguments on the cold path.
+//
+// check_instructions.cmake also disassembles the probes and checks the
+// instructions executed when the pointer is not null. The make_unique and
+// comparison probes check that the factories and the operators that never
+// throw compile to the same code as their std counterparts.
+
+#include <throwing/not_null.hpp>
+#include <throwing/shared_ptr.hpp>
+#include <throwing/unique_ptr.hpp>
+
+struct Probe {
+    int value;
+};
+
+extern "C" {
+int probe_std_shared_star(const std::shared_ptr<int> &p);
+int probe_throwing_shared_star(const throwing::shared_ptr<int> &p);
+int probe_std_shared_arrow(const std::shared_ptr<Probe> &p);
+int probe_throwing_shared_arrow(const throwing::shared_ptr<Probe> &p);
+int probe_std_unique_star(const std::unique_ptr<int> &p);
+int probe_throwing_unique_star(const throwing::unique_ptr<int> &p);
+int probe_std_unique_arrow(const std::unique_ptr<Probe> &p);
+int probe_throwing_unique_arrow(const throwing::unique_ptr<Probe> &p);
+int probe_std_unique_array_index(const std::unique_ptr<int[]> &p);
+int probe_throwing_unique_array_index(const throwing::unique_ptr<int[]> &p);
+#if defined(__cpp_lib_shared_ptr_arrays)
+int probe_std_shared_array_index(const std::shared_ptr<int[]> &p);
+int probe_throwing_shared_array_index(throwing::shared_ptr<int[]> &p);
+#endif
+int probe_std_located_result_value(const std::shared_ptr<int> &p);
+int probe_throwing_located_result_value(const throwing::shared_ptr<int> &p);
+int probe_std_unchecked_shared_star(const std::shared_ptr<int> &p);
+int probe_throwing_unchecked_shared_star(const throwing::shared_ptr<int> &p);
+int probe_std_unchecked_shared_twice(const std::shared_ptr<Probe> &p);
+int probe_throwing_unchecked_shared_twice(
+        const throwing::shared_ptr<Probe> &p);
+int probe_std_unchecked_not_null_arrow(const std::shared_ptr<Probe> &p);
+int probe_throwing_unchecked_not_null_arrow(
+        const throwing::not_null<throwing::shared_ptr<Probe>> &p);
+int probe_std_unchecked_unique_star(const std::unique_ptr<int> &p);
+int probe_throwing_unchecked_unique_star(const throwing::unique_ptr<int> &p);
+int probe_std_unchecked_unique_array_index(const std::unique_ptr<int[]> &p);
+int probe_throwing_unchecked_unique_array_index(
+        const throwing::unique_ptr<int[]> &p);
+void probe_std_make_unique(std::unique_ptr<int> &p);
+void probe_throwing_make_unique(throwing::unique_ptr<int> &p);
+bool probe_std_shared_equal(const std::shared_ptr<int> &a,
+                            const std::shared_ptr<int> &b);
+bool probe_throwing_shared_equal(const throwing::shared_ptr<int> &a,
+                                 const throwing::shared_ptr<int> &b);
+bool probe_std_shared_less(const std::shared_ptr<int> &a,
+                           const std::shared_ptr<int> &b);
+bool probe_throwing_shared_less(const throwing::shared_ptr<int> &a,
+                                const throwing::shared_ptr<int> &b);
+bool probe_std_shared_equal_null(const std::shared_ptr<int> &p);
+bool probe_throwing_shared_equal_null(const throwing::shared_ptr<int> &p);
+bool probe_std_unique_equal(const std::unique_ptr<int> &a,
+                            const std::unique_ptr<int> &b);
+bool probe_throwing_unique_equal(const throwing::unique_ptr<int> &a,
+                                 const throwing::unique_ptr<int> &b);
+bool probe_std_unique_less(const std::unique_ptr<int> &a,
+                           const std::unique_ptr<int> &b);
+bool probe_throwing_unique_less(const throwing::unique_ptr<int> &a,
+                                const throwing::unique_ptr<int> &b);
+bool probe_std_unique_equal_null(const std::unique_ptr<int> &p);
+bool probe_throwing_unique_equal_null(const throwing::unique_ptr<int> &p);
+
+int probe_std_shared_star(const std::shared_ptr<int> &p) { return *p; }
+int probe_throwing_shared_star(const throwing::shared_ptr<int> &p) {
+    return *p;
+}
+
+int probe_std_shared_arrow(const std::shared_ptr<Probe> &p) {
+    return p->value;
+}
+int probe_throwing_shared_arrow(const throwing::shared_ptr<Probe> &p) {
+    return p->value;
+}
+
+int probe_std_unique_star(const std::unique_ptr<int> &p) { return *p; }
+int probe_throwing_unique_star(const throwing::unique_ptr<int> &p) {
+    return *p;
+}
+
+int probe_std_unique_arrow(const std::unique_ptr<Probe> &p) {
+    return p->value;
+}
+int probe_throwing_unique_arrow(const throwing::unique_ptr<Probe> &p) {
+    return p->value;
+}
+
+int probe_std_unique_array_index(const std::unique_ptr<int[]> &p) {
+    return p[3];
+}
+int probe_throwing_unique_array_index(const throwing::unique_ptr<int[]> &p) {
+    return p[3];
+}
+
+#if defined(__cpp_lib_shared_ptr_arrays)
+int probe_std_shared_array_index(const std::shared_ptr<int[]> &p) {
+    return p[3];
+}
+int probe_throwing_shared_array_index(throwing::shared_ptr<int[]> &p) {
+    return p[3];
+}
+#endif
+
+// value() passes the location of its caller to the cold path only, the
+// non-null path must match probe_throwing_shared_star
+int probe_std_located_result_value(const std::shared_ptr<int> &p) { return *p; }
+int probe_throwing_located_result_value(const throwing::shared_ptr<int> &p) {
+    return p.try_deref().value();
+}
+
+int probe_std_unchecked_shared_star(const std::shared_ptr<int> &p) {
+    return *p;
+}
+int probe_throwing_unchecked_shared_star(const throwing::shared_ptr<int> &p) {
+    return p.deref_unchecked();
+}
+
+// The checked dereference following get_nonnull() must not test again
+int probe_std_unchecked_shared_twice(const std::shared_ptr<Probe> &p) {
+    return p.get()->value + p->value;
+}
+int probe_throwing_unchecked_shared_twice(
+        const throwing::shared_ptr<Probe> &p) {
+    return p.get_nonnull()->value + p->value;
+}
+
+int probe_std_unchecked_not_null_arrow(const std::shared_ptr<Probe> &p) {
+    return p->value;
+}
+int probe_throwing_unchecked_not_null_arrow(
+        const throwing::not_null<throwing::shared_ptr<Probe>> &p) {
+    return p->value;
+}
+
+int probe_std_unchecked_unique_star(const std::unique_ptr<int> &p) {
+    return *p;
+}
+int probe_throwing_unchecked_unique_star(const throwing::unique_ptr<int> &p) {
+    return p.deref_unchecked();
+}
+
+int probe_std_unchecked_unique_array_index(const std::unique_ptr<int[]> &p) {
+    return p[3];
+}
+int probe_throwing_unchecked_unique_array_index(
+        const throwing::unique_ptr<int[]> &p) {
+    return p.index_unchecked(3);
+}
+
+// std::make_unique is not available in C++11
+void probe_std_make_unique(std::unique_ptr<int> &p) { p.reset(new int(42)); }
+void probe_throwing_make_unique(throwing::unique_ptr<int> &p) {
+    p = throwing::make_unique<int>(42);
+}
+
+bool probe_std_shared_equal(const std::shared_ptr<int> &a,
+                            const std::shared_ptr<int> &b) {
+    return a == b;
+}
+bool probe_throwing_shared_equal(const throwing::shared_ptr<int> &a,
+                                 const throwing::shared_ptr<int> &b) {
+    return a == b;
+}
+
+bool probe_std_shared_less(const std::shared_ptr<int> &a,
+                           const std::shared_ptr<int> &b) {
+    return a < b;
+}
+bool probe_throwing_shared_less(const throwing::shared_ptr<int> &a,
+                                const throwing::shared_ptr<int> &b) {
+    return a < b;
+}
+
+bool probe_std_shared_equal_null(const std::shared_ptr<int> &p) {
+    return p == nullptr;
+}
+bool probe_throwing_shared_equal_null(const throwing::shared_ptr<int> &p) {
+    return p == nullptr;
+}
+
+bool probe_std_unique_equal(const std::unique_ptr<int> &a,
+                            const std::unique_ptr<int> &b) {
+    return a == b;
+}
+bool probe_throwing_unique_equal(const throwing::unique_ptr<int> &a,
+                                 const throwing::unique_ptr<int> &b) {
+    return a == b;
+}
+
+bool probe_std_unique_less(const std::unique_ptr<int> &a,
+                           const std::unique_ptr<int> &b) {
+    return a < b;
+}
+bool probe_throwing_unique_less(const throwing::unique_ptr<int> &a,
+                                const throwing::unique_ptr<int> &b) {
+    return a < b;
+}
+
+bool probe_std_unique_equal_null(const std::unique_ptr<int> &p) {
+    return p == nullptr;
+}
+bool probe_throwing_unique_equal_null(const throwing::unique_ptr<int> &p) {
+    return p == nullptr;
+}
+}
@@ -0,0 +1,33 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Uses the smart pointers to a type declared with
+// THROWING_PTR_EXTERN_TEMPLATES and to one that is not. Built without
+// optimization, the non-template members used here are emitted out of line
+// for ImplicitWidget and must only be referenced for ExternWidget.
+
+#include "../explicit_instantiation.h"
+
+struct ImplicitWidget {
+    int value = 42;
+};
+
+template <typename T> int use_pointers() {
+    throwing::shared_ptr<T> shared;
+    throwing::shared_ptr<T> copy = shared;
+    throwing::weak_ptr<T> weak;
+    throwing::unique_ptr<T> unique;
+    int result = static_cast<int>(copy.use_count());
+    if (weak.expired())
+        result += (*shared).value;
+    if (nullptr == unique.get())
+        result += unique->value;
+    unique.reset();
+    return result;
+}
+
+int probe_extern() { return use_pointers<ExternWidget>(); }
+
+int probe_implicit() { return use_pointers<ImplicitWidget>(); }
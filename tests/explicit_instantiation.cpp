@@ -0,0 +1,47 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <catch.hpp>
+#include <string>
+
+#include "explicit_instantiation.h"
+
+TEST_CASE("extern shared_ptr and weak_ptr templates can be used",
+          "[explicit_instantiation]") {
+    throwing::shared_ptr<ExternWidget> p(new ExternWidget);
+    throwing::shared_ptr<ExternWidget> copy = p;
+    REQUIRE(copy->value == 42);
+    REQUIRE((*copy).value == 42);
+    REQUIRE(p.use_count() == 2);
+
+    throwing::weak_ptr<ExternWidget> weak = p;
+    REQUIRE(weak.lock() == p);
+    p.reset();
+    copy.reset();
+    REQUIRE(weak.expired());
+}
+
+TEST_CASE("extern unique_ptr templates can be used",
+          "[explicit_instantiation]") {
+    throwing::unique_ptr<ExternWidget> p(new ExternWidget);
+    REQUIRE(p->value == 42);
+    p.reset();
+    REQUIRE(p == nullptr);
+}
+
+TEST_CASE("extern null_ptr_exception templates are thrown",
+          "[explicit_instantiation]") {
+    throwing::shared_ptr<ExternWidget> shared;
+    REQUIRE_THROWS_AS(*shared, throwing::null_ptr_exception<ExternWidget>);
+    throwing::unique_ptr<ExternWidget> unique;
+    try {
+        unique->value = 1;
+        FAIL("no exception thrown");
+    } catch (const throwing::null_ptr_exception<ExternWidget> &e) {
+        REQUIRE(std::string(e.type_name()) == "ExternWidget");
+        REQUIRE(std::string(e.what_type()) ==
+                "Dereferenced nullptr of type ExternWidget");
+    }
+}
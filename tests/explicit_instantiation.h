@@ -0,0 +1,16 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// A type whose smart pointers are instantiated once, in
+// explicit_instantiation_definitions.cpp
+
+#pragma once
+#include <throwing/explicit_instantiation.hpp>
+
+struct ExternWidget {
+    int value = 42;
+};
+
+THROWING_PTR_EXTERN_TEMPLATES(ExternWidget)
@@ -0,0 +1,8 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "explicit_instantiation.h"
+
+THROWING_PTR_INSTANTIATE_TEMPLATES(ExternWidget)
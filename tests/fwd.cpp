@@ -0,0 +1,62 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <catch.hpp>
+#include <memory>
+#include <throwing/fwd.hpp>
+#include <type_traits>
+
+struct FwdDeclared;
+
+// Declarations that only need throwing/fwd.hpp, with an incomplete pointee
+long fwd_use_count(const throwing::shared_ptr<FwdDeclared> &p);
+bool fwd_expired(const throwing::weak_ptr<FwdDeclared> &p);
+bool fwd_empty(const throwing::unique_ptr<FwdDeclared> &p);
+
+#include <throwing/shared_ptr.hpp>
+#include <throwing/unique_ptr.hpp>
+
+struct FwdDeclared {
+    int value;
+};
+
+long fwd_use_count(const throwing::shared_ptr<FwdDeclared> &p) {
+    return p.use_count();
+}
+
+bool fwd_expired(const throwing::weak_ptr<FwdDeclared> &p) {
+    return p.expired();
+}
+
+bool fwd_empty(const throwing::unique_ptr<FwdDeclared> &p) {
+    return p == nullptr;
+}
+
+TEST_CASE("fwd.hpp declares the default template arguments", "[fwd]") {
+    static_assert(std::is_same<throwing::shared_ptr<int>,
+                               throwing::shared_ptr<
+                                       int, throwing::throw_on_null>>::value,
+                  "shared_ptr throws on null by default");
+    static_assert(std::is_same<throwing::weak_ptr<int>,
+                               throwing::weak_ptr<
+                                       int, throwing::throw_on_null>>::value,
+                  "weak_ptr throws on null by default");
+    static_assert(
+            std::is_same<throwing::unique_ptr<int>,
+                         throwing::unique_ptr<int, std::default_delete<int>,
+                                              throwing::throw_on_null>>::value,
+            "unique_ptr uses std::default_delete and throws on null by "
+            "default");
+}
+
+TEST_CASE("functions declared with fwd.hpp take the defined types",
+          "[fwd]") {
+    throwing::shared_ptr<FwdDeclared> shared;
+    throwing::weak_ptr<FwdDeclared> weak;
+    throwing::unique_ptr<FwdDeclared> unique;
+    REQUIRE(fwd_use_count(shared) == 0);
+    REQUIRE(fwd_expired(weak));
+    REQUIRE(fwd_empty(unique));
+}
@@ -0,0 +1,273 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <catch.hpp>
+#include <memory>
+#include <throwing/local_shared_ptr.hpp>
+#include <type_traits>
+
+namespace {
+
+class Base {
+public:
+    virtual ~Base() = default;
+    virtual bool is_derived() const { return false; }
+    int value = 1;
+};
+
+class Derived : public Base {
+public:
+    bool is_derived() const override { return true; }
+};
+
+struct Counted {
+    explicit Counted(int &alive) : alive(alive) { ++alive; }
+    ~Counted() { --alive; }
+    int &alive;
+};
+
+struct CountingDeleter {
+    int *calls;
+    void operator()(int *p) const {
+        ++*calls;
+        delete p;
+    }
+};
+
+struct Pair {
+    int first = 1;
+    int second = 2;
+};
+
+} // namespace
+
+TEST_CASE("fwd.hpp declares the default null policy of local_shared_ptr",
+          "[local_shared_ptr]") {
+    static_assert(
+            std::is_same<throwing::local_shared_ptr<int>,
+                         throwing::local_shared_ptr<
+                                 int, throwing::throw_on_null>>::value,
+            "local_shared_ptr throws on null by default");
+    static_assert(std::is_same<throwing::local_weak_ptr<int>,
+                               throwing::local_weak_ptr<
+                                       int, throwing::throw_on_null>>::value,
+                  "local_weak_ptr throws on null by default");
+}
+
+TEST_CASE("local_shared_ptr dereferences like shared_ptr",
+          "[local_shared_ptr][nullptr]") {
+    throwing::local_shared_ptr<Pair> empty;
+    REQUIRE_THROWS_AS(*empty, throwing::null_ptr_exception<Pair> &);
+    REQUIRE_THROWS_AS(empty->first, throwing::null_ptr_exception<Pair> &);
+    REQUIRE_FALSE(empty.try_deref().has_value());
+    REQUIRE(empty.value_or(Pair()).second == 2);
+
+    auto p = throwing::make_local_shared<Pair>();
+    REQUIRE(p->first == 1);
+    REQUIRE((*p).second == 2);
+    REQUIRE(p.get_nonnull() == p.get());
+    REQUIRE(&p.deref_unchecked() == p.get());
+    REQUIRE(&p.try_deref().value() == p.get());
+    REQUIRE(p.and_then([](Pair &v) {
+                 return throwing::deref_result<int>(&v.second);
+             }).value() == 2);
+}
+
+TEST_CASE("local_shared_ptr takes a null policy",
+          "[local_shared_ptr][null_policy]") {
+    throwing::local_shared_ptr<int, throwing::unchecked_on_null> p =
+            throwing::make_local_shared<int>(3);
+    REQUIRE(*p == 3);
+}
+
+TEST_CASE("local_shared_ptr counts owners", "[local_shared_ptr]") {
+    int alive = 0;
+    {
+        throwing::local_shared_ptr<Counted> p(new Counted(alive));
+        REQUIRE(alive == 1);
+        REQUIRE(p.use_count() == 1);
+        {
+            throwing::local_shared_ptr<Counted> copy = p;
+            REQUIRE(p.use_count() == 2);
+            throwing::local_shared_ptr<Counted> moved = std::move(copy);
+            REQUIRE_FALSE(copy);
+            REQUIRE(copy.use_count() == 0);
+            REQUIRE(p.use_count() == 2);
+        }
+        REQUIRE(p.use_count() == 1);
+        p.reset();
+        REQUIRE(alive == 0);
+        REQUIRE(p == nullptr);
+    }
+    REQUIRE(alive == 0);
+}
+
+TEST_CASE("make_local_shared constructs the object in place",
+          "[local_shared_ptr][make_shared]") {
+    int alive = 0;
+    {
+        auto p = throwing::make_local_shared<Counted>(alive);
+        REQUIRE(alive == 1);
+        throwing::local_weak_ptr<Counted> weak = p;
+        p.reset();
+        REQUIRE(alive == 0);
+        REQUIRE(weak.expired());
+    }
+    REQUIRE(alive == 0);
+}
+
+TEST_CASE("local_shared_ptr calls its deleter once",
+          "[local_shared_ptr][construction]") {
+    int calls = 0;
+    {
+        throwing::local_shared_ptr<int> p(new int(5), CountingDeleter{&calls});
+        throwing::local_shared_ptr<int> copy = p;
+        p.reset(new int(6), CountingDeleter{&calls});
+        REQUIRE(calls == 0);
+    }
+    REQUIRE(calls == 2);
+}
+
+TEST_CASE("local_shared_ptr takes ownership from unique_ptr",
+          "[local_shared_ptr][construction]") {
+    std::unique_ptr<int> unique(new int(7));
+    throwing::local_shared_ptr<int> p(std::move(unique));
+    REQUIRE_FALSE(unique);
+    REQUIRE(*p == 7);
+    REQUIRE(p.use_count() == 1);
+
+    std::unique_ptr<int> empty;
+    throwing::local_shared_ptr<int> q(std::move(empty));
+    REQUIRE_FALSE(q);
+    REQUIRE(q.use_count() == 0);
+}
+
+TEST_CASE("local_shared_ptr converts and aliases",
+          "[local_shared_ptr][construction]") {
+    throwing::local_shared_ptr<Derived> derived =
+            throwing::make_local_shared<Derived>();
+    throwing::local_shared_ptr<Base> base = derived;
+    REQUIRE(base->is_derived());
+    REQUIRE(derived.use_count() == 2);
+
+    auto pair = throwing::make_local_shared<Pair>();
+    throwing::local_shared_ptr<int> second(pair, &pair->second);
+    pair.reset();
+    REQUIRE(*second == 2);
+    REQUIRE(second.use_count() == 1);
+
+    base = std::move(derived);
+    REQUIRE_FALSE(derived);
+    REQUIRE(base.use_count() == 1);
+}
+
+TEST_CASE("local_shared_ptr casts share ownership",
+          "[local_shared_ptr][cast]") {
+    throwing::local_shared_ptr<Base> base =
+            throwing::make_local_shared<Derived>();
+
+    auto derived = throwing::dynamic_pointer_cast<Derived>(base);
+    REQUIRE(derived);
+    REQUIRE(base.use_count() == 2);
+    auto up = throwing::static_pointer_cast<Base>(derived);
+    REQUIRE(up == base);
+    REQUIRE(base.use_count() == 3);
+
+    throwing::local_shared_ptr<Base> not_derived =
+            throwing::make_local_shared<Base>();
+    auto failed = throwing::dynamic_pointer_cast<Derived>(not_derived);
+    REQUIRE_FALSE(failed);
+    REQUIRE(failed.use_count() == 0);
+    REQUIRE(not_derived.use_count() == 1);
+
+    throwing::local_shared_ptr<const Base> constant = base;
+    REQUIRE(throwing::const_pointer_cast<Base>(constant) == base);
+
+    auto pair = throwing::make_local_shared<Pair>();
+    REQUIRE(*throwing::reinterpret_pointer_cast<int>(pair) == 1);
+}
+
+TEST_CASE("local_weak_ptr locks while the object is alive",
+          "[local_shared_ptr][weak_ptr]") {
+    throwing::local_weak_ptr<int> empty;
+    REQUIRE(empty.expired());
+    REQUIRE_FALSE(empty.lock());
+    REQUIRE_FALSE(empty.try_deref().has_value());
+
+    auto p = throwing::make_local_shared<int>(42);
+    throwing::local_weak_ptr<int> weak = p;
+    throwing::local_weak_ptr<int> copy = weak;
+    REQUIRE(p.use_count() == 1);
+    REQUIRE(weak.use_count() == 1);
+    {
+        auto locked = copy.lock();
+        REQUIRE(*locked == 42);
+        REQUIRE(p.use_count() == 2);
+    }
+    REQUIRE(weak.value_or(7) == 42);
+    REQUIRE(weak.and_then([](int &i) {
+                    return throwing::deref_result<int>(&i);
+                }).value() == 42);
+
+    auto result = weak.try_deref();
+    p.reset();
+    REQUIRE_FALSE(weak.expired());
+    REQUIRE(result.value() == 42);
+    result = throwing::deref_result<int, throwing::local_shared_ptr<int>>(
+            throwing::local_shared_ptr<int>());
+
+    REQUIRE(weak.expired());
+    REQUIRE_FALSE(copy.lock());
+    REQUIRE(weak.value_or(7) == 7);
+    REQUIRE_THROWS_AS(weak.try_deref().value(),
+                      throwing::null_ptr_exception<int> &);
+}
+
+TEST_CASE("local_weak_ptr outlives the managed object",
+          "[local_shared_ptr][weak_ptr]") {
+    int alive = 0;
+    throwing::local_weak_ptr<Counted> weak;
+    {
+        throwing::local_shared_ptr<Counted> p(new Counted(alive));
+        weak = p;
+    }
+    REQUIRE(alive == 0);
+    REQUIRE(weak.expired());
+    weak.reset();
+    REQUIRE(weak.use_count() == 0);
+}
+
+TEST_CASE("local_shared_ptr swaps and compares",
+          "[local_shared_ptr][swap][comparison]") {
+    auto a = throwing::make_local_shared<int>(1);
+    auto b = throwing::make_local_shared<int>(2);
+    const int *a_address = a.get();
+    swap(a, b);
+    REQUIRE(b.get() == a_address);
+    REQUIRE(*a == 2);
+    REQUIRE(a != b);
+    REQUIRE((a < b) == std::less<int *>()(a.get(), b.get()));
+    REQUIRE(a != nullptr);
+    REQUIRE_FALSE(nullptr == a);
+
+    throwing::local_weak_ptr<int> weak_a = a;
+    throwing::local_weak_ptr<int> weak_b = b;
+    swap(weak_a, weak_b);
+    REQUIRE(weak_a.lock() == b);
+}
+
+TEST_CASE("local_shared_ptr orders by owner", "[local_shared_ptr][ordering]") {
+    auto pair = throwing::make_local_shared<Pair>();
+    throwing::local_shared_ptr<int> first(pair, &pair->first);
+    throwing::local_shared_ptr<int> second(pair, &pair->second);
+    REQUIRE(first != second);
+    REQUIRE_FALSE(first.owner_before(second));
+    REQUIRE_FALSE(second.owner_before(pair));
+
+    auto other = throwing::make_local_shared<Pair>();
+    throwing::local_weak_ptr<Pair> weak_other = other;
+    REQUIRE(pair.owner_before(weak_other) != other.owner_before(pair));
+    REQUIRE_FALSE(weak_other.owner_before(other));
+}
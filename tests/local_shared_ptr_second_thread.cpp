@@ -0,0 +1,21 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Copies a local_shared_ptr on a thread other than the one that created it,
+// which must fail the assertion of the control block.
+
+#undef NDEBUG
+#include <thread>
+#include <throwing/local_shared_ptr.hpp>
+
+int main() {
+    auto p = throwing::make_local_shared<int>(42);
+    std::thread other([&p] {
+        throwing::local_shared_ptr<int> copy = p;
+        (void)copy;
+    });
+    other.join();
+    return 0;
+}
@@ -0,0 +1,133 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Uses the library through the throwing module only. Catch is not used, so
+// that no throwing header is included textually.
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+import throwing;
+
+namespace {
+
+int failures = 0;
+
+#define MODULE_CHECK(expr)                                                     \
+    do {                                                                       \
+        if (!(expr)) {                                                         \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,        \
+                         __LINE__, #expr);                                     \
+            ++failures;                                                        \
+        }                                                                      \
+    } while (false)
+
+struct base {
+    virtual ~base() = default;
+    int value = 1;
+};
+
+struct derived : base {
+    int other = 2;
+};
+
+void shared_ptr_operations() {
+    throwing::shared_ptr<derived> d = throwing::make_shared<derived>();
+    throwing::shared_ptr<base> b = d;
+    MODULE_CHECK(b->value == 1);
+    MODULE_CHECK(b == d);
+    MODULE_CHECK(throwing::dynamic_pointer_cast<derived>(b)->other == 2);
+    MODULE_CHECK(throwing::static_pointer_cast<derived>(b) == d);
+
+    throwing::weak_ptr<base> w = b;
+    MODULE_CHECK(w.lock() == b);
+    b.reset();
+    d.reset();
+    MODULE_CHECK(w.expired());
+    MODULE_CHECK(w.lock() == nullptr);
+
+    throwing::shared_ptr<int> p = throwing::make_shared<int>(1);
+    throwing::shared_ptr<int> q = throwing::make_shared<int>(2);
+    throwing::atomic_store(&p, q);
+    MODULE_CHECK(*throwing::atomic_load(&p) == 2);
+
+    throwing::atomic_shared_ptr<int> a(p);
+    a.store(throwing::make_shared<int>(3));
+    MODULE_CHECK(*a.load() == 3);
+
+    throwing::atomic_weak_ptr<int> aw(p);
+    MODULE_CHECK(aw.lock() == p);
+}
+
+void local_shared_ptr_operations() {
+    throwing::local_shared_ptr<derived> d =
+            throwing::make_local_shared<derived>();
+    throwing::local_shared_ptr<base> b = d;
+    MODULE_CHECK(b.use_count() == 2);
+    MODULE_CHECK(throwing::dynamic_pointer_cast<derived>(b)->other == 2);
+
+    throwing::local_weak_ptr<base> w = b;
+    MODULE_CHECK(w.lock() == d);
+    b.reset();
+    d.reset();
+    MODULE_CHECK(w.expired());
+}
+
+void unique_ptr_operations() {
+    throwing::unique_ptr<derived> d = throwing::make_unique<derived>();
+    MODULE_CHECK(d->other == 2);
+    throwing::unique_ptr<base> b = std::move(d);
+    MODULE_CHECK(d == nullptr);
+    MODULE_CHECK((*b).value == 1);
+
+    throwing::unique_ptr<int[]> array = throwing::make_unique<int[]>(3);
+    array[2] = 42;
+    MODULE_CHECK(array[2] == 42);
+}
+
+void null_dereferences() {
+    throwing::shared_ptr<int> shared;
+    try {
+        failures += *shared;
+        MODULE_CHECK(false);
+    } catch (const throwing::null_ptr_exception<int> &e) {
+        MODULE_CHECK(std::strcmp(e.type_name(), "int") == 0);
+    }
+
+    throwing::unique_ptr<int> unique;
+    try {
+        failures += *unique;
+        MODULE_CHECK(false);
+    } catch (const throwing::base_null_ptr_exception &) {
+    }
+
+    MODULE_CHECK(!shared.try_deref().has_value());
+    MODULE_CHECK(shared.try_deref().value_or(3) == 3);
+}
+
+void not_null_operations() {
+    throwing::shared_ptr<int> p = throwing::make_shared<int>(4);
+    throwing::not_null<throwing::shared_ptr<int>> checked = p;
+    MODULE_CHECK(*checked == 4);
+    try {
+        throwing::not_null<throwing::shared_ptr<int>> null_checked =
+                throwing::shared_ptr<int>();
+        MODULE_CHECK(false);
+    } catch (const throwing::null_ptr_exception<int> &) {
+    }
+}
+
+} // namespace
+
+int main() {
+    shared_ptr_operations();
+    local_shared_ptr_operations();
+    unique_ptr_operations();
+    null_dereferences();
+    not_null_operations();
+    return failures;
+}
@@ -0,0 +1,133 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Tests built with exceptions disabled. Catch requires exception support, so
+// this file uses a minimal check macro and its own main.
+//
+// Run without arguments, the operations that do not throw are checked, then a
+// null pointer is dereferenced with a handler installed that exits with
+// status 0. Run with "default_handler", a null pointer is dereferenced with
+// the default handler installed, which logs to stderr and aborts.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <throwing/shared_ptr.hpp>
+#include <throwing/unique_ptr.hpp>
+#include <typeinfo>
+#include <utility>
+
+#include "test_helpers.h"
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#error no_exceptions.cpp must be compiled with exceptions disabled
+#endif
+
+namespace {
+
+int failures = 0;
+
+#define NOEXC_CHECK(expr)                                                      \
+    do {                                                                       \
+        if (!(expr)) {                                                         \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,        \
+                         __LINE__, #expr);                                     \
+            ++failures;                                                        \
+        }                                                                      \
+    } while (false)
+
+void shared_ptr_operations() {
+    throwing::shared_ptr<TestDerivedClass> derived =
+            throwing::make_shared<TestDerivedClass>();
+    NOEXC_CHECK(derived->dummy() == 2);
+    NOEXC_CHECK((*derived).dummy() == 2);
+    NOEXC_CHECK(derived.use_count() == 1);
+
+    throwing::shared_ptr<TestBaseClass> base = derived;
+    NOEXC_CHECK(base.get() == derived.get());
+    NOEXC_CHECK(base == derived);
+    NOEXC_CHECK(base.use_count() == 2);
+
+    auto cast = throwing::static_pointer_cast<TestDerivedClass>(base);
+    NOEXC_CHECK(cast == derived);
+
+    throwing::shared_ptr<TestBaseClass> other(new TestBaseClass);
+    swap(base, other);
+    NOEXC_CHECK(base != derived);
+    NOEXC_CHECK(other == derived);
+
+    base.reset();
+    NOEXC_CHECK(!base);
+    NOEXC_CHECK(base == nullptr);
+    NOEXC_CHECK(std::hash<throwing::shared_ptr<TestDerivedClass>>()(derived) ==
+                std::hash<TestDerivedClass *>()(derived.get()));
+}
+
+void weak_ptr_operations() {
+    throwing::shared_ptr<int> shared = throwing::make_shared<int>(42);
+    throwing::weak_ptr<int> weak = shared;
+    NOEXC_CHECK(!weak.expired());
+    NOEXC_CHECK(*weak.lock() == 42);
+
+    shared.reset();
+    NOEXC_CHECK(weak.expired());
+    NOEXC_CHECK(weak.lock() == nullptr);
+}
+
+void unique_ptr_operations() {
+    throwing::unique_ptr<TestDerivedClass> derived =
+            throwing::make_unique<TestDerivedClass>();
+    NOEXC_CHECK(derived->dummy() == 2);
+    TestDerivedClass *raw = derived.get();
+
+    throwing::unique_ptr<TestBaseClass> base = std::move(derived);
+    NOEXC_CHECK(base.get() == raw);
+    NOEXC_CHECK(derived == nullptr);
+
+    delete base.release();
+    NOEXC_CHECK(!base);
+
+    throwing::unique_ptr<int[]> array(new int[3]);
+    array[2] = 42;
+    NOEXC_CHECK(array[2] == 42);
+    array.reset(nullptr);
+    NOEXC_CHECK(array == nullptr);
+}
+
+void null_handler_registration() {
+    throwing::null_handler initial = throwing::get_null_handler();
+    NOEXC_CHECK(initial != nullptr);
+    NOEXC_CHECK(throwing::set_null_handler(nullptr) == initial);
+    NOEXC_CHECK(throwing::get_null_handler() == initial);
+}
+
+void exit_if_int(const std::type_info &type) {
+    if (failures == 0 && type == typeid(int)) {
+        std::exit(EXIT_SUCCESS);
+    }
+    std::fprintf(stderr, "unexpected null handler call for %s\n",
+                 type.name());
+    std::exit(EXIT_FAILURE);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    throwing::shared_ptr<int> nothing;
+    if (argc > 1 && std::strcmp(argv[1], "default_handler") == 0) {
+        return ++*nothing;
+    }
+
+    shared_ptr_operations();
+    weak_ptr_operations();
+    unique_ptr_operations();
+    null_handler_registration();
+
+    throwing::set_null_handler(&exit_if_int);
+    int value = *nothing;
+    std::fprintf(stderr, "null handler was not called\n");
+    return value;
+}
@@ -0,0 +1,125 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <catch.hpp>
+#include <functional>
+#include <throwing/not_null.hpp>
+#include <throwing/shared_ptr.hpp>
+#include <throwing/unique_ptr.hpp>
+#include <type_traits>
+
+#include "test_helpers.h"
+
+namespace {
+struct Foo {
+    int foo() const { return 42; }
+};
+
+int call_foo(throwing::not_null<throwing::shared_ptr<Foo>> p) {
+    return p->foo();
+}
+} // namespace
+
+TEST_CASE("not_null throws upon construction from a null pointer",
+          "[not_null][nullptr]") {
+    throwing::shared_ptr<Foo> nothing;
+    REQUIRE_THROWS_AS(throwing::not_null<throwing::shared_ptr<Foo>>(nothing),
+                      throwing::null_ptr_exception<Foo>&);
+    REQUIRE_THROWS_AS(call_foo(nothing), throwing::null_ptr_exception<Foo>&);
+
+    Foo *raw = nullptr;
+    REQUIRE_THROWS_AS(throwing::not_null<Foo *>(raw),
+                      throwing::null_ptr_exception<Foo>&);
+
+    REQUIRE_THROWS_AS(throwing::not_null<throwing::unique_ptr<Foo>>(
+                              throwing::unique_ptr<Foo>()),
+                      throwing::null_ptr_exception<Foo>&);
+}
+
+TEST_CASE("not_null cannot be constructed from nullptr", "[not_null]") {
+    static_assert(
+            !std::is_constructible<throwing::not_null<int *>,
+                                   std::nullptr_t>::value,
+            "not_null must not be constructible from nullptr");
+    static_assert(
+            !std::is_assignable<throwing::not_null<int *> &,
+                                std::nullptr_t>::value,
+            "not_null must not be assignable from nullptr");
+}
+
+TEST_CASE("not_null dereferences the wrapped pointer", "[not_null][access]") {
+    throwing::shared_ptr<Foo> t_ptr = throwing::make_shared<Foo>();
+    throwing::not_null<throwing::shared_ptr<Foo>> shared = t_ptr;
+    REQUIRE(shared->foo() == 42);
+    REQUIRE(&*shared == t_ptr.get());
+    REQUIRE(call_foo(t_ptr) == 42);
+
+    Foo foo;
+    throwing::not_null<Foo *> raw = &foo;
+    REQUIRE(raw->foo() == 42);
+    REQUIRE(&*raw == &foo);
+
+    throwing::not_null<throwing::unique_ptr<Foo>> unique(
+            throwing::make_unique<Foo>());
+    REQUIRE(unique->foo() == 42);
+}
+
+TEST_CASE("not_null converts back to the wrapped pointer",
+          "[not_null][access]") {
+    throwing::shared_ptr<Foo> t_ptr = throwing::make_shared<Foo>();
+    throwing::not_null<throwing::shared_ptr<Foo>> shared = t_ptr;
+    const throwing::shared_ptr<Foo> &back = shared;
+    REQUIRE(back == t_ptr);
+    REQUIRE(shared.get() == t_ptr);
+    REQUIRE(t_ptr.use_count() == 2);
+}
+
+TEST_CASE("not_null copies and converts without leaving a null behind",
+          "[not_null][assignment]") {
+    throwing::not_null<throwing::shared_ptr<TestDerivedClass>> derived =
+            throwing::make_shared<TestDerivedClass>();
+    throwing::not_null<throwing::shared_ptr<TestBaseClass>> base = derived;
+    REQUIRE(base.get() == derived.get());
+
+    throwing::not_null<throwing::shared_ptr<TestBaseClass>> moved =
+            std::move(base);
+    REQUIRE(base.get() != nullptr);
+    REQUIRE(moved == base);
+
+    static_assert(!std::is_copy_constructible<throwing::not_null<
+                          throwing::unique_ptr<Foo>>>::value,
+                  "not_null<unique_ptr> must not be copyable");
+    static_assert(!std::is_move_constructible<throwing::not_null<
+                          throwing::unique_ptr<Foo>>>::value,
+                  "not_null<unique_ptr> must not be movable");
+}
+
+TEST_CASE("not_null compares like the wrapped pointer",
+          "[not_null][comparison]") {
+    int values[2] = {1, 2};
+    throwing::not_null<int *> first = &values[0];
+    throwing::not_null<int *> second = &values[1];
+    throwing::not_null<const int *> first_const = first;
+
+    REQUIRE(first == first_const);
+    REQUIRE(first != second);
+    REQUIRE(first < second);
+    REQUIRE(first <= second);
+    REQUIRE(second > first);
+    REQUIRE(second >= first);
+}
+
+TEST_CASE("not_null hashes like the wrapped pointer", "[not_null][hash]") {
+    throwing::not_null<throwing::shared_ptr<Foo>> shared =
+            throwing::make_shared<Foo>();
+    REQUIRE(std::hash<throwing::not_null<throwing::shared_ptr<Foo>>>()(
+                    shared) ==
+            std::hash<throwing::shared_ptr<Foo>>()(shared.get()));
+
+    int value = 0;
+    throwing::not_null<int *> raw = &value;
+    REQUIRE(std::hash<throwing::not_null<int *>>()(raw) ==
+            std::hash<int *>()(&value));
+}
@@ -0,0 +1,138 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <catch.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <throwing/not_null.hpp>
+#include <throwing/null_ptr_exception.hpp>
+#include <throwing/shared_ptr.hpp>
+
+TEST_CASE("null_ptr_exception what() returns a generic message",
+          "[exception]") {
+    const throwing::null_ptr_exception<int> e;
+    REQUIRE(std::string(e.what()) == "Dereference of nullptr");
+}
+
+TEST_CASE("null_ptr_exception is a std::logic_error", "[exception]") {
+    try {
+        throw throwing::null_ptr_exception<int>();
+    } catch (const std::logic_error &e) {
+        REQUIRE(std::string(e.what()) == "Dereference of nullptr");
+    }
+}
+
+TEST_CASE("null_ptr_exception what() survives copies", "[exception]") {
+    throwing::null_ptr_exception<int> e;
+    const throwing::null_ptr_exception<int> copy(e);
+    e = throwing::null_ptr_exception<int>();
+    REQUIRE(std::string(copy.what()) == "Dereference of nullptr");
+    REQUIRE(std::string(e.what()) == "Dereference of nullptr");
+}
+
+TEST_CASE("null_ptr_exception what_type() is cached per type",
+          "[exception]") {
+    const throwing::null_ptr_exception<int> e1;
+    const throwing::null_ptr_exception<int> e2;
+    REQUIRE(e1.what_type() == e2.what_type());
+
+    const throwing::null_ptr_exception<float> f;
+    REQUIRE(std::strcmp(e1.what_type(), f.what_type()) != 0);
+}
+
+namespace type_name_test {
+struct Foo {};
+} // namespace type_name_test
+
+TEST_CASE("null_ptr_exception type_name() is readable", "[exception]") {
+    const throwing::null_ptr_exception<int> e;
+    REQUIRE(std::string(e.type_name()) == "int");
+    REQUIRE(std::string(e.what_type()) == "Dereferenced nullptr of type int");
+
+    const throwing::null_ptr_exception<type_name_test::Foo> foo;
+    REQUIRE(std::string(foo.type_name()).find("type_name_test::Foo") !=
+            std::string::npos);
+}
+
+TEST_CASE("null_ptr_exception type_name() is cached per type",
+          "[exception]") {
+    const throwing::null_ptr_exception<int> e1;
+    const throwing::null_ptr_exception<int> e2;
+    REQUIRE(e1.type_name() == e2.type_name());
+
+    const throwing::base_null_ptr_exception &base = e1;
+    REQUIRE(base.type_name() == e1.type_name());
+}
+
+TEST_CASE("base_null_ptr_exception what_type() is empty", "[exception]") {
+    const throwing::base_null_ptr_exception e;
+    REQUIRE(std::string(e.what_type()).empty());
+    REQUIRE(std::string(e.type_name()).empty());
+}
+
+TEST_CASE("null_ptr_exception without a location has empty accessors",
+          "[exception][location]") {
+    const throwing::null_ptr_exception<int> e;
+    REQUIRE(std::string(e.file()) == "");
+    REQUIRE(e.line() == 0);
+    REQUIRE(std::string(e.function()) == "");
+    REQUIRE(e.address() == nullptr);
+}
+
+TEST_CASE("null_ptr_exception records no stack trace by default",
+          "[exception][stack_trace]") {
+    throwing::shared_ptr<int> nothing;
+    try {
+        (*nothing)++;
+        FAIL();
+    } catch (const throwing::base_null_ptr_exception &e) {
+        REQUIRE(e.stack_size() == 0);
+        REQUIRE(e.stack_trace() == "");
+    }
+}
+
+TEST_CASE("null_ptr_exception thrown by operators records the caller address",
+          "[exception][location]") {
+    throwing::shared_ptr<int> nothing;
+    try {
+        (*nothing)++;
+        FAIL();
+    } catch (const throwing::base_null_ptr_exception &e) {
+#if defined(__GNUC__) || defined(_MSC_VER)
+        REQUIRE(e.address() != nullptr);
+#endif
+        REQUIRE(e.line() == 0);
+    }
+}
+
+#if defined(__GNUC__)
+TEST_CASE("null_ptr_exception thrown by value() records the call site",
+          "[exception][location]") {
+    throwing::shared_ptr<int> nothing;
+    const unsigned line = __LINE__ + 2;
+    try {
+        nothing.try_deref().value();
+        FAIL();
+    } catch (const throwing::base_null_ptr_exception &e) {
+        REQUIRE(std::string(e.file()) == __FILE__);
+        REQUIRE(e.line() == line);
+        REQUIRE(std::string(e.function()) != "");
+    }
+}
+
+TEST_CASE("null_ptr_exception thrown by not_null records the call site",
+          "[exception][location]") {
+    int *nothing = nullptr;
+    const unsigned line = __LINE__ + 2;
+    try {
+        throwing::not_null<int *> checked(nothing);
+        FAIL();
+    } catch (const throwing::null_ptr_exception<int> &e) {
+        REQUIRE(std::string(e.file()) == __FILE__);
+        REQUIRE(e.line() == line);
+    }
+}
+#endif
@@ -105,3 +105,12 @@ TEST_CASE("operator bool works", "[shared_ptr]") {
     ptr.reset();
     REQUIRE_FALSE(ptr);
 }
+
+TEST_CASE("shared_ptr unchecked accessors return the stored pointer",
+          "[shared_ptr][access][unchecked]") {
+    Foo *ptr = new Foo;
+    throwing::shared_ptr<Foo> t_ptr(ptr);
+    REQUIRE(t_ptr.get_nonnull() == ptr);
+    REQUIRE(&t_ptr.deref_unchecked() == ptr);
+    REQUIRE(t_ptr.deref_unchecked().foo() == 42);
+}
@@ -3,8 +3,11 @@
 //    (See accompanying file LICENSE or copy at
 //          http://www.boost.org/LICENSE_1_0.txt)
 
+#include <atomic>
 #include <catch.hpp>
+#include <thread>
 #include <throwing/shared_ptr.hpp>
+#include <vector>
 
 TEST_CASE("atomic_is_lock_free std::shared_ptr compatibility",
           "[shared_ptr][atomic]") {
@@ -126,3 +129,43 @@ TEST_CASE("atomic_compare_exchange_strong_explicit works in the same thread, "
             std::memory_order_seq_cst));
     REQUIRE(*expected == 1);
 }
+
+TEST_CASE("atomic_* functions keep a consistent count across threads",
+          "[shared_ptr][atomic]") {
+    const int threads = 4;
+    const int iterations = 20000;
+    const auto first = throwing::make_shared<int>(0);
+    auto p = first;
+    std::atomic<bool> bad_value(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < iterations; ++i) {
+                switch ((i + t) % 4) {
+                case 0:
+                    if (*atomic_load(&p) < 0)
+                        bad_value = true;
+                    break;
+                case 1:
+                    atomic_store(&p, throwing::make_shared<int>(i));
+                    break;
+                case 2:
+                    if (*atomic_exchange(&p, throwing::make_shared<int>(i)) < 0)
+                        bad_value = true;
+                    break;
+                default: {
+                    auto expected = atomic_load(&p);
+                    atomic_compare_exchange_weak(
+                            &p, &expected,
+                            throwing::make_shared<int>(*expected));
+                } break;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    REQUIRE_FALSE(bad_value);
+    REQUIRE(first.use_count() == 1);
+    REQUIRE(p.use_count() == 1);
+}
@@ -0,0 +1,152 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <catch.hpp>
+#include <functional>
+#include <throwing/shared_ptr.hpp>
+#include <type_traits>
+#include <typeinfo>
+
+#include "test_helpers.h"
+
+namespace {
+struct callback_exception {
+    const std::type_info *type;
+};
+
+void throw_callback_exception(const std::type_info &type) {
+    throw callback_exception{&type};
+}
+
+typedef throwing::callback_on_null<throw_callback_exception> callback_policy;
+
+struct Foo {
+    int foo() const { return 42; }
+};
+} // namespace
+
+TEST_CASE("shared_ptr with callback policy calls the callback on nullptr",
+          "[shared_ptr][null_policy][nullptr]") {
+    throwing::shared_ptr<Foo, callback_policy> nothing;
+    try {
+        nothing->foo();
+        FAIL();
+    } catch (const callback_exception &e) {
+        REQUIRE(*e.type == typeid(Foo));
+    }
+    REQUIRE_THROWS_AS(*nothing, callback_exception);
+}
+
+TEST_CASE("shared_ptr with non throwing policies dereferences valid pointers",
+          "[shared_ptr][null_policy]") {
+    throwing::shared_ptr<Foo, throwing::terminate_on_null> terminating(
+            new Foo);
+    REQUIRE(terminating->foo() == 42);
+    REQUIRE((*terminating).foo() == 42);
+
+    throwing::shared_ptr<Foo, throwing::unchecked_on_null> unchecked(new Foo);
+    REQUIRE(unchecked->foo() == 42);
+    REQUIRE((*unchecked).foo() == 42);
+}
+
+TEST_CASE("shared_ptr converts between policies",
+          "[shared_ptr][null_policy][construction][assignment]") {
+    throwing::shared_ptr<TestDerivedClass> t_ptr =
+            throwing::make_shared<TestDerivedClass>();
+
+    throwing::shared_ptr<TestBaseClass, throwing::unchecked_on_null>
+            unchecked = t_ptr;
+    REQUIRE(unchecked.get() == t_ptr.get());
+    REQUIRE(unchecked.use_count() == 2);
+
+    throwing::shared_ptr<TestBaseClass> back;
+    back = unchecked;
+    REQUIRE(back.get() == t_ptr.get());
+    REQUIRE(back.use_count() == 3);
+
+    throwing::shared_ptr<TestBaseClass, callback_policy> moved(
+            std::move(unchecked));
+    REQUIRE(moved.get() == t_ptr.get());
+    REQUIRE(unchecked.get() == nullptr);
+}
+
+TEST_CASE("shared_ptr from make_shared converts to other policies",
+          "[shared_ptr][null_policy][make_shared]") {
+    throwing::shared_ptr<int, throwing::terminate_on_null> t_ptr =
+            throwing::make_shared<int>(42);
+    REQUIRE(*t_ptr == 42);
+}
+
+TEST_CASE("shared_ptr casts preserve the policy",
+          "[shared_ptr][null_policy][cast]") {
+    throwing::shared_ptr<TestBaseClass, callback_policy> base =
+            throwing::make_shared<TestDerivedClass>();
+
+    auto derived = throwing::static_pointer_cast<TestDerivedClass>(base);
+    static_assert(
+            std::is_same<decltype(derived),
+                         throwing::shared_ptr<TestDerivedClass,
+                                              callback_policy>>::value,
+            "static_pointer_cast must preserve the policy");
+    REQUIRE(derived->dummy() == 2);
+
+    auto as_const = throwing::const_pointer_cast<const TestBaseClass>(base);
+    static_assert(
+            std::is_same<decltype(as_const),
+                         throwing::shared_ptr<const TestBaseClass,
+                                              callback_policy>>::value,
+            "const_pointer_cast must preserve the policy");
+    REQUIRE(as_const.get() == base.get());
+
+    throwing::shared_ptr<int, callback_policy> nothing;
+    auto cast_nothing = throwing::reinterpret_pointer_cast<float>(nothing);
+    REQUIRE_THROWS_AS(*cast_nothing, callback_exception);
+}
+
+TEST_CASE("shared_ptr compares across policies",
+          "[shared_ptr][null_policy][comparison]") {
+    throwing::shared_ptr<int> t_ptr = throwing::make_shared<int>(42);
+    throwing::shared_ptr<int, throwing::unchecked_on_null> unchecked = t_ptr;
+    throwing::shared_ptr<int, callback_policy> other =
+            throwing::make_shared<int>(42);
+    std::shared_ptr<int> std_ptr = t_ptr.get_std_shared_ptr();
+
+    REQUIRE(t_ptr == unchecked);
+    REQUIRE_FALSE(t_ptr != unchecked);
+    REQUIRE(unchecked != other);
+    REQUIRE((unchecked < other) == (t_ptr.get() < other.get()));
+    REQUIRE(unchecked == std_ptr);
+    REQUIRE(std_ptr == unchecked);
+    REQUIRE(unchecked != nullptr);
+    REQUIRE(nullptr != unchecked);
+}
+
+TEST_CASE("shared_ptr with a policy hashes like the std pointer",
+          "[shared_ptr][null_policy][hash]") {
+    throwing::shared_ptr<int, throwing::unchecked_on_null> t_ptr =
+            throwing::make_shared<int>(42);
+    REQUIRE(std::hash<
+                    throwing::shared_ptr<int, throwing::unchecked_on_null>>()(
+                    t_ptr) == std::hash<int *>()(t_ptr.get()));
+}
+
+TEST_CASE("weak_ptr lock returns a shared_ptr with the same policy",
+          "[weak_ptr][null_policy]") {
+    throwing::shared_ptr<int, callback_policy> t_ptr =
+            throwing::make_shared<int>(42);
+    throwing::weak_ptr<int, callback_policy> weak = t_ptr;
+    static_assert(std::is_same<decltype(weak.lock()),
+                               throwing::shared_ptr<int, callback_policy>>::
+                          value,
+                  "lock must preserve the policy");
+    REQUIRE(*weak.lock() == 42);
+
+    t_ptr.reset();
+    REQUIRE_THROWS_AS(*weak.lock(), callback_exception);
+
+    throwing::weak_ptr<int> default_weak = weak;
+    REQUIRE_THROWS_AS(*default_weak.lock(),
+                      throwing::null_ptr_exception<int>);
+}
@@ -0,0 +1,110 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <catch.hpp>
+#include <memory>
+#include <thread>
+#include <throwing/shared_ptr.hpp>
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+
+TEST_CASE("std::atomic<shared_ptr> is lock free as its std counterpart",
+          "[shared_ptr][std_atomic]") {
+    std::atomic<throwing::shared_ptr<int>> a;
+    const std::atomic<std::shared_ptr<int>> std_a;
+    REQUIRE(a.is_lock_free() == std_a.is_lock_free());
+    REQUIRE(std::atomic<throwing::shared_ptr<int>>::is_always_lock_free ==
+            std::atomic<std::shared_ptr<int>>::is_always_lock_free);
+}
+
+TEST_CASE("std::atomic<shared_ptr> load, store and exchange",
+          "[shared_ptr][std_atomic]") {
+    const auto p1 = throwing::make_shared<int>(1);
+    const auto p2 = throwing::make_shared<int>(2);
+    std::atomic<throwing::shared_ptr<int>> a(p1);
+    REQUIRE(a.load() == p1);
+    REQUIRE(p1.use_count() == 2);
+
+    a.store(p2, std::memory_order_release);
+    REQUIRE(p1.use_count() == 1);
+    const throwing::shared_ptr<int> loaded = a;
+    REQUIRE(loaded == p2);
+
+    const auto previous = a.exchange(p1);
+    REQUIRE(previous == p2);
+    a = nullptr;
+    REQUIRE(a.load(std::memory_order_acquire) == nullptr);
+    a = p2;
+    REQUIRE(*a.load() == 2);
+}
+
+TEST_CASE("std::atomic<shared_ptr> compare exchange compares pointers, not "
+          "values",
+          "[shared_ptr][std_atomic]") {
+    const auto p = throwing::make_shared<int>(1);
+    std::atomic<throwing::shared_ptr<int>> a(p);
+    auto expected = throwing::make_shared<int>(1);
+    const auto desired = throwing::make_shared<int>(2);
+
+    REQUIRE_FALSE(a.compare_exchange_strong(expected, desired));
+    REQUIRE(expected == p);
+    REQUIRE(a.compare_exchange_strong(expected, desired,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_acquire));
+    REQUIRE(a.load() == desired);
+    expected = desired;
+    while (!a.compare_exchange_weak(expected, p)) {
+    }
+    REQUIRE(a.load() == p);
+}
+
+TEST_CASE("std::atomic<shared_ptr> wait returns once the pointer changes",
+          "[shared_ptr][std_atomic]") {
+    const auto p1 = throwing::make_shared<int>(1);
+    const auto p2 = throwing::make_shared<int>(2);
+    std::atomic<throwing::shared_ptr<int>> a(p1);
+
+    std::thread waiter([&] { a.wait(p1); });
+    a.store(p2);
+    a.notify_all();
+    waiter.join();
+    REQUIRE(a.load() == p2);
+}
+
+TEST_CASE("std::atomic<weak_ptr> load, store and compare exchange",
+          "[weak_ptr][std_atomic]") {
+    const auto p1 = throwing::make_shared<int>(1);
+    const auto p2 = throwing::make_shared<int>(2);
+    std::atomic<throwing::weak_ptr<int>> a(p1);
+    REQUIRE(a.load().lock() == p1);
+    REQUIRE(p1.use_count() == 1);
+
+    a.store(p2);
+    const throwing::weak_ptr<int> loaded = a;
+    REQUIRE(loaded.lock() == p2);
+    REQUIRE(a.exchange(p1).lock() == p2);
+
+    throwing::weak_ptr<int> expected(p2);
+    REQUIRE_FALSE(a.compare_exchange_strong(expected, p2));
+    REQUIRE(expected.lock() == p1);
+    REQUIRE(a.compare_exchange_strong(expected, p2));
+    REQUIRE(a.load().lock() == p2);
+}
+
+TEST_CASE("std::atomic<weak_ptr> wait returns once the pointer changes",
+          "[weak_ptr][std_atomic]") {
+    const auto p1 = throwing::make_shared<int>(1);
+    const auto p2 = throwing::make_shared<int>(2);
+    std::atomic<throwing::weak_ptr<int>> a(p1);
+
+    std::thread waiter([&] { a.wait(p1); });
+    a.store(p2);
+    a.notify_one();
+    waiter.join();
+    REQUIRE(a.load().lock() == p2);
+}
+
+#endif
@@ -44,3 +44,11 @@ TEST_CASE("shared_ptr to array: [0] returns first element",
     throwing::shared_ptr<int[10]> t_ptr(ptr);
     REQUIRE(&t_ptr[0] == ptr);
 }
+
+TEST_CASE("shared_ptr to array: index_unchecked returns elements",
+          "[shared_ptr][array][access][unchecked]") {
+    int *ptr = new int[10];
+    throwing::shared_ptr<int[10]> t_ptr(ptr);
+    REQUIRE(&t_ptr.index_unchecked(0) == ptr);
+    REQUIRE(&t_ptr.index_unchecked(9) == ptr + 9);
+}
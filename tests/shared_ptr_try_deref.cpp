@@ -0,0 +1,68 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <catch.hpp>
+#include <string>
+#include <throwing/shared_ptr.hpp>
+
+namespace {
+struct Node {
+    int value = 42;
+    throwing::shared_ptr<Node> next;
+};
+} // namespace
+
+TEST_CASE("shared_ptr try_deref on nullptr returns an error",
+          "[shared_ptr][try_deref][nullptr]") {
+    throwing::shared_ptr<int> nothing;
+    auto result = nothing.try_deref();
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE_FALSE(result);
+    REQUIRE(std::string(result.error().what_type()) ==
+            throwing::null_ptr_exception<int>().what_type());
+    REQUIRE_THROWS_AS(result.value(), throwing::null_ptr_exception<int>&);
+}
+
+TEST_CASE("shared_ptr try_deref references the pointed-to object",
+          "[shared_ptr][try_deref]") {
+    throwing::shared_ptr<int> t_ptr = throwing::make_shared<int>(42);
+    auto result = t_ptr.try_deref();
+    REQUIRE(result.has_value());
+    REQUIRE(&result.value() == t_ptr.get());
+    REQUIRE(&*result == t_ptr.get());
+
+    *result = 43;
+    REQUIRE(*t_ptr == 43);
+}
+
+TEST_CASE("shared_ptr value_or returns the default on nullptr",
+          "[shared_ptr][try_deref][nullptr]") {
+    throwing::shared_ptr<int> nothing;
+    REQUIRE(nothing.value_or(7) == 7);
+
+    throwing::shared_ptr<int> t_ptr = throwing::make_shared<int>(42);
+    REQUIRE(t_ptr.value_or(7) == 42);
+
+    throwing::shared_ptr<std::string> no_string;
+    REQUIRE(no_string.value_or("default") == "default");
+}
+
+TEST_CASE("shared_ptr and_then chains dereferences",
+          "[shared_ptr][try_deref]") {
+    auto next = [](Node &n) { return n.next.try_deref(); };
+
+    throwing::shared_ptr<Node> head = throwing::make_shared<Node>();
+    REQUIRE_FALSE(head.and_then(next).has_value());
+    REQUIRE_FALSE(head.and_then(next).and_then(next).has_value());
+
+    head->next = throwing::make_shared<Node>();
+    head->next->value = 43;
+    auto second = head.and_then(next);
+    REQUIRE(second.has_value());
+    REQUIRE(second->value == 43);
+
+    throwing::shared_ptr<Node> nothing;
+    REQUIRE_FALSE(nothing.and_then(next).has_value());
+}
@@ -0,0 +1,75 @@
+#          Copyright Claudio Bantaloukas 2017-2018.
+# Distributed under the Boost Software License, Version 1.0.
+#    (See accompanying file LICENSE or copy at
+#          http://www.boost.org/LICENSE_1_0.txt)
+
+# Compares the sections of THROWING, a program dereferencing throwing smart
+# pointers to TYPES distinct types, with those of STD, the same program using
+# the std smart pointers, and reports the bytes added per type:
+#   code: .text and the PLT
+#   data: read-only data, vtables, typeinfo, unwind tables, dynamic
+#         relocations and initialized data
+#   bss: zero-initialized data, e.g. the caches of the type names
+# Fails if the code or data added per type exceed CODE_BUDGET or DATA_BUDGET.
+#
+# Usage: cmake -DSIZE=<size> -DTHROWING=<program> -DSTD=<program>
+#              -DTYPES=<count> -DCODE_BUDGET=<bytes> -DDATA_BUDGET=<bytes>
+#              -P <this file>
+
+foreach(var SIZE THROWING STD TYPES CODE_BUDGET DATA_BUDGET)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "${var} must be defined")
+    endif()
+endforeach()
+
+# Sets <prefix>_code, <prefix>_data and <prefix>_bss to the sizes of the
+# sections of program
+function(measure program prefix)
+    execute_process(COMMAND ${SIZE} -A ${program}
+        OUTPUT_VARIABLE sections
+        RESULT_VARIABLE size_result)
+    if(NOT size_result EQUAL 0)
+        message(FATAL_ERROR "${SIZE} failed on ${program}")
+    endif()
+    set(code 0)
+    set(data 0)
+    set(bss 0)
+    string(REPLACE "\n" ";" lines "${sections}")
+    foreach(line ${lines})
+        if(NOT line MATCHES "^(\\.[^ ]+) +([0-9]+) +[0-9]+$")
+            continue()
+        endif()
+        set(section ${CMAKE_MATCH_1})
+        set(bytes ${CMAKE_MATCH_2})
+        if(section MATCHES "^\\.(text|plt)")
+            math(EXPR code "${code} + ${bytes}")
+        elseif(section MATCHES "^\\.(bss|tbss)")
+            math(EXPR bss "${bss} + ${bytes}")
+        elseif(section MATCHES
+                "^\\.(rodata|data|eh_frame|gcc_except_table|rela|rel\\.|got)")
+            math(EXPR data "${data} + ${bytes}")
+        endif()
+    endforeach()
+    set(${prefix}_code ${code} PARENT_SCOPE)
+    set(${prefix}_data ${data} PARENT_SCOPE)
+    set(${prefix}_bss ${bss} PARENT_SCOPE)
+endfunction()
+
+measure(${THROWING} throwing)
+measure(${STD} std)
+
+set(failed FALSE)
+foreach(kind code data bss)
+    math(EXPR added "${throwing_${kind}} - ${std_${kind}}")
+    math(EXPR per_type "${added} / ${TYPES}")
+    message(STATUS "${kind}: ${throwing_${kind}} bytes, std ${std_${kind}} "
+        "bytes, ${per_type} bytes per type")
+    if(kind STREQUAL "code" AND per_type GREATER CODE_BUDGET)
+        message(SEND_ERROR "code per type exceeds the budget of "
+            "${CODE_BUDGET} bytes")
+    endif()
+    if(kind STREQUAL "data" AND per_type GREATER DATA_BUDGET)
+        message(SEND_ERROR "data per type exceeds the budget of "
+            "${DATA_BUDGET} bytes")
+    endif()
+endforeach()
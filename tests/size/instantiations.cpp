@@ -0,0 +1,60 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Dereferences a shared_ptr and a unique_ptr to each of TSP_SIZE_TYPES
+// distinct types. Built once with the throwing smart pointers and once, with
+// TSP_SIZE_STD defined, with the std ones; check_size.cmake divides the
+// difference in size between the two programs by the number of types.
+
+#include <cstddef>
+#include <memory>
+#include <throwing/shared_ptr.hpp>
+#include <throwing/unique_ptr.hpp>
+
+#if !defined(TSP_SIZE_TYPES)
+#error TSP_SIZE_TYPES must be defined
+#endif
+
+#if defined(TSP_SIZE_STD)
+template <typename T> using shared_type = std::shared_ptr<T>;
+template <typename T> using unique_type = std::unique_ptr<T>;
+#else
+template <typename T> using shared_type = throwing::shared_ptr<T>;
+template <typename T> using unique_type = throwing::unique_ptr<T>;
+#endif
+
+template <int I> struct pointee {
+    int value;
+};
+
+typedef int (*probe_function)(const void *, const void *);
+
+template <int I>
+__attribute__((noinline)) int probe(const void *shared, const void *unique) {
+    const auto &s = *static_cast<const shared_type<pointee<I>> *>(shared);
+    const auto &u = *static_cast<const unique_type<pointee<I>> *>(unique);
+    return s->value + (*u).value;
+}
+
+// Fills a table with the address of probe<I> for each I < N, instantiating
+// all of them
+template <int N> struct probe_table {
+    static void fill(probe_function *table) {
+        probe_table<N - 1>::fill(table);
+        table[N - 1] = &probe<N - 1>;
+    }
+};
+
+template <> struct probe_table<0> {
+    static void fill(probe_function *) {}
+};
+
+int main() {
+    static probe_function table[TSP_SIZE_TYPES];
+    probe_table<TSP_SIZE_TYPES>::fill(table);
+    // Keep the table alive without running the probes
+    probe_function *volatile keep = table;
+    return keep[TSP_SIZE_TYPES - 1] == nullptr ? 1 : 0;
+}
@@ -0,0 +1,72 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Built in its own executable with THROWING_PTR_BACKTRACE defined and the
+// functions of the program exported, so that their names can be resolved
+
+#include <catch.hpp>
+#include <string>
+#include <throwing/shared_ptr.hpp>
+
+#if !defined(THROWING_PTR_BACKTRACE)
+#error stack_trace.cpp must be compiled with THROWING_PTR_BACKTRACE defined
+#endif
+
+__attribute__((noinline)) int
+stack_trace_dereference(const throwing::shared_ptr<int> &p) {
+    return *p + 1;
+}
+
+__attribute__((noinline)) int
+stack_trace_recurse(const throwing::shared_ptr<int> &p, int depth) {
+    if (depth == 0)
+        return stack_trace_dereference(p);
+    return stack_trace_recurse(p, depth - 1) + 1;
+}
+
+TEST_CASE("null_ptr_exception records the stack from the dereference",
+          "[stack_trace]") {
+    throwing::shared_ptr<int> nothing;
+    try {
+        stack_trace_dereference(nothing);
+        FAIL();
+    } catch (const throwing::base_null_ptr_exception &e) {
+        REQUIRE(e.stack_size() > 1);
+        REQUIRE(e.stack_frames()[0] == e.address());
+        const std::string trace = e.stack_trace();
+        REQUIRE(trace.find("#0") == 0);
+        REQUIRE(trace.find("stack_trace_dereference") != std::string::npos);
+        REQUIRE(trace.find("throw_null_ptr_exception") == std::string::npos);
+    }
+}
+
+TEST_CASE("null_ptr_exception stack survives copies", "[stack_trace]") {
+    throwing::shared_ptr<int> nothing;
+    try {
+        stack_trace_dereference(nothing);
+        FAIL();
+    } catch (const throwing::null_ptr_exception<int> &e) {
+        const throwing::null_ptr_exception<int> copy(e);
+        REQUIRE(copy.stack_size() == e.stack_size());
+        REQUIRE(copy.stack_trace() == e.stack_trace());
+    }
+}
+
+TEST_CASE("null_ptr_exception stack is bounded", "[stack_trace]") {
+    throwing::shared_ptr<int> nothing;
+    try {
+        stack_trace_recurse(nothing, 2 * THROWING_PTR_BACKTRACE_DEPTH);
+        FAIL();
+    } catch (const throwing::base_null_ptr_exception &e) {
+        REQUIRE(e.stack_size() == THROWING_PTR_BACKTRACE_DEPTH);
+    }
+}
+
+TEST_CASE("null_ptr_exception not thrown by a smart pointer has no stack",
+          "[stack_trace]") {
+    const throwing::null_ptr_exception<int> e;
+    REQUIRE(e.stack_size() == 0);
+    REQUIRE(e.stack_trace() == "");
+}
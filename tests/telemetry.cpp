@@ -0,0 +1,96 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Built in its own executable with THROWING_PTR_TELEMETRY defined
+
+#include <catch.hpp>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <throwing/shared_ptr.hpp>
+#include <throwing/telemetry.hpp>
+#include <throwing/unique_ptr.hpp>
+#include <vector>
+
+#if !defined(THROWING_PTR_TELEMETRY)
+#error telemetry.cpp must be compiled with THROWING_PTR_TELEMETRY defined
+#endif
+
+namespace {
+struct Counted {
+    int value = 0;
+};
+struct CountedByThreads {
+    int value = 0;
+};
+struct NeverNull {
+    int value = 0;
+};
+
+std::uint64_t count_of(const std::string &type_name) {
+    std::uint64_t result = 0;
+    throwing::for_each_null_dereference_count(
+            [&](const char *name, std::uint64_t count) {
+                if (type_name == name)
+                    result = count;
+            });
+    return result;
+}
+
+template <typename Pointer> void dereference_null(const Pointer &p) {
+    try {
+        p->value++;
+    } catch (const throwing::base_null_ptr_exception &) {
+    }
+}
+} // namespace
+
+TEST_CASE("null dereferences are counted per type", "[telemetry]") {
+    const std::string name = throwing::null_ptr_exception<Counted>().type_name();
+    const std::uint64_t before = count_of(name);
+
+    throwing::shared_ptr<Counted> shared;
+    throwing::unique_ptr<Counted> unique;
+    dereference_null(shared);
+    dereference_null(unique);
+    REQUIRE(count_of(name) == before + 2);
+
+    throwing::unique_ptr<int[]> array;
+    const std::uint64_t before_int = count_of("int");
+    try {
+        array[0]++;
+    } catch (const throwing::base_null_ptr_exception &) {
+    }
+    REQUIRE(count_of("int") == before_int + 1);
+}
+
+TEST_CASE("types without null dereferences are not listed", "[telemetry]") {
+    throwing::shared_ptr<NeverNull> ptr = throwing::make_shared<NeverNull>();
+    ptr->value++;
+    const std::string name =
+            throwing::null_ptr_exception<NeverNull>().type_name();
+    for (const auto &entry : throwing::null_dereference_counts()) {
+        REQUIRE(name != entry.type_name);
+    }
+}
+
+TEST_CASE("null dereferences are counted across threads", "[telemetry]") {
+    const std::size_t threads = 8;
+    const std::size_t per_thread = 1000;
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([] {
+            throwing::shared_ptr<CountedByThreads> nothing;
+            for (std::size_t j = 0; j < per_thread; ++j)
+                dereference_null(nothing);
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    const std::string name =
+            throwing::null_ptr_exception<CountedByThreads>().type_name();
+    REQUIRE(count_of(name) == threads * per_thread);
+}
@@ -61,3 +61,12 @@ TEST_CASE("unique_ptr exceptions have non-empty what()",
         REQUIRE_FALSE(what.empty());
     }
 }
+
+TEST_CASE("unique_ptr unchecked accessors return the stored pointer",
+          "[unique_ptr][dereference][unchecked]") {
+    Foo *ptr = new Foo;
+    throwing::unique_ptr<Foo> t_ptr(ptr);
+    REQUIRE(t_ptr.get_nonnull() == ptr);
+    REQUIRE(&t_ptr.deref_unchecked() == ptr);
+    REQUIRE(t_ptr.deref_unchecked().foo() == 42);
+}
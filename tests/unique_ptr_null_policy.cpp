@@ -0,0 +1,107 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <catch.hpp>
+#include <functional>
+#include <throwing/unique_ptr.hpp>
+#include <typeinfo>
+
+#include "test_helpers.h"
+
+namespace {
+struct callback_exception {
+    const std::type_info *type;
+};
+
+void throw_callback_exception(const std::type_info &type) {
+    throw callback_exception{&type};
+}
+
+typedef throwing::callback_on_null<throw_callback_exception> callback_policy;
+} // namespace
+
+TEST_CASE("unique_ptr with callback policy calls the callback on nullptr",
+          "[unique_ptr][null_policy][nullptr]") {
+    throwing::unique_ptr<TestBaseClass, std::default_delete<TestBaseClass>,
+                         callback_policy>
+            nothing;
+    try {
+        nothing->dummy();
+        FAIL();
+    } catch (const callback_exception &e) {
+        REQUIRE(*e.type == typeid(TestBaseClass));
+    }
+    REQUIRE_THROWS_AS(*nothing, callback_exception);
+}
+
+TEST_CASE("unique_ptr to array with callback policy calls the callback on "
+          "nullptr",
+          "[unique_ptr][null_policy][nullptr]") {
+    throwing::unique_ptr<int[], std::default_delete<int[]>, callback_policy>
+            nothing;
+    try {
+        nothing[0]++;
+        FAIL();
+    } catch (const callback_exception &e) {
+        REQUIRE(*e.type == typeid(int));
+    }
+}
+
+TEST_CASE("unique_ptr with non throwing policies dereferences valid pointers",
+          "[unique_ptr][null_policy]") {
+    throwing::unique_ptr<TestBaseClass, std::default_delete<TestBaseClass>,
+                         throwing::terminate_on_null>
+            terminating(new TestBaseClass);
+    REQUIRE(terminating->dummy() == 1);
+    REQUIRE((*terminating).dummy() == 1);
+
+    throwing::unique_ptr<int[], std::default_delete<int[]>,
+                         throwing::unchecked_on_null>
+            unchecked(new int[2]);
+    unchecked[1] = 42;
+    REQUIRE(unchecked[1] == 42);
+}
+
+TEST_CASE("unique_ptr converts between policies",
+          "[unique_ptr][null_policy][construction][assignment]") {
+    throwing::unique_ptr<TestDerivedClass> t_ptr =
+            throwing::make_unique<TestDerivedClass>();
+    TestDerivedClass *raw = t_ptr.get();
+
+    throwing::unique_ptr<TestBaseClass, std::default_delete<TestBaseClass>,
+                         throwing::unchecked_on_null>
+            unchecked(std::move(t_ptr));
+    REQUIRE(unchecked.get() == raw);
+    REQUIRE(t_ptr.get() == nullptr);
+
+    throwing::unique_ptr<TestBaseClass> back;
+    back = std::move(unchecked);
+    REQUIRE(back.get() == raw);
+    REQUIRE(unchecked.get() == nullptr);
+}
+
+TEST_CASE("unique_ptr compares across policies",
+          "[unique_ptr][null_policy][comparison]") {
+    throwing::unique_ptr<int> t_ptr = throwing::make_unique<int>(42);
+    throwing::unique_ptr<int, std::default_delete<int>,
+                         throwing::unchecked_on_null>
+            unchecked = throwing::make_unique<int>(42);
+
+    REQUIRE(t_ptr != unchecked);
+    REQUIRE_FALSE(t_ptr == unchecked);
+    REQUIRE((t_ptr < unchecked) == (t_ptr.get() < unchecked.get()));
+    REQUIRE(unchecked != nullptr);
+    REQUIRE(nullptr != unchecked);
+}
+
+TEST_CASE("unique_ptr with a policy hashes like the std pointer",
+          "[unique_ptr][null_policy][hash]") {
+    typedef throwing::unique_ptr<int, std::default_delete<int>,
+                                 throwing::unchecked_on_null>
+            unchecked_ptr;
+    unchecked_ptr t_ptr = throwing::make_unique<int>(42);
+    REQUIRE(std::hash<unchecked_ptr>()(t_ptr) ==
+            std::hash<int *>()(t_ptr.get()));
+}
@@ -51,3 +51,12 @@ TEST_CASE("unique_ptr to array: operator bool", "[unique_ptr][array][bool]") {
     throwing::unique_ptr<int[]> something(new int[10]);
     REQUIRE(something);
 }
+
+TEST_CASE("unique_ptr to array: unchecked accessors return elements",
+          "[unique_ptr][array][access][unchecked]") {
+    int *ptr = new int[10];
+    throwing::unique_ptr<int[]> t_ptr(ptr);
+    REQUIRE(t_ptr.get_nonnull() == ptr);
+    REQUIRE(&t_ptr.index_unchecked(0) == ptr);
+    REQUIRE(&t_ptr.index_unchecked(9) == ptr + 9);
+}
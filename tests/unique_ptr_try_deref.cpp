@@ -0,0 +1,51 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <catch.hpp>
+#include <throwing/unique_ptr.hpp>
+
+namespace {
+struct Node {
+    int value = 42;
+    throwing::unique_ptr<Node> next;
+};
+} // namespace
+
+TEST_CASE("unique_ptr try_deref on nullptr returns an error",
+          "[unique_ptr][try_deref][nullptr]") {
+    throwing::unique_ptr<int> nothing;
+    auto result = nothing.try_deref();
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE_THROWS_AS(result.value(), throwing::null_ptr_exception<int>&);
+}
+
+TEST_CASE("unique_ptr try_deref references the pointed-to object",
+          "[unique_ptr][try_deref]") {
+    throwing::unique_ptr<int> t_ptr = throwing::make_unique<int>(42);
+    auto result = t_ptr.try_deref();
+    REQUIRE(result.has_value());
+    REQUIRE(&result.value() == t_ptr.get());
+}
+
+TEST_CASE("unique_ptr value_or returns the default on nullptr",
+          "[unique_ptr][try_deref][nullptr]") {
+    throwing::unique_ptr<int> nothing;
+    REQUIRE(nothing.value_or(7) == 7);
+
+    throwing::unique_ptr<const int> t_ptr(new int(42));
+    REQUIRE(t_ptr.value_or(7) == 42);
+}
+
+TEST_CASE("unique_ptr and_then chains dereferences",
+          "[unique_ptr][try_deref]") {
+    auto next = [](Node &n) { return n.next.try_deref(); };
+
+    throwing::unique_ptr<Node> head = throwing::make_unique<Node>();
+    REQUIRE_FALSE(head.and_then(next).has_value());
+
+    head->next = throwing::make_unique<Node>();
+    head->next->value = 43;
+    REQUIRE(head.and_then(next)->value == 43);
+}
@@ -0,0 +1,44 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Built with THROWING_PTR_USDT defined. Calls each function that fires a USDT
+// probe, so that check_usdt_probes.cmake can look for the probes in the ELF
+// notes of the executable.
+
+#include <atomic>
+#include <memory>
+#include <throwing/shared_ptr.hpp>
+#include <throwing/unique_ptr.hpp>
+
+int main() {
+    int failures = 0;
+
+    throwing::shared_ptr<int> shared = throwing::make_shared<int>(1);
+    throwing::shared_ptr<int> allocated =
+            throwing::allocate_shared<int>(std::allocator<int>(), 2);
+    throwing::unique_ptr<int> unique = throwing::make_unique<int>(3);
+    throwing::unique_ptr<int[]> array = throwing::make_unique<int[]>(4);
+
+    throwing::shared_ptr<int> loaded = atomic_load(&shared);
+    atomic_store(&shared, allocated);
+    loaded = atomic_exchange(&shared, loaded);
+    throwing::shared_ptr<int> expected = atomic_load(&shared);
+    if (!atomic_compare_exchange_strong(&shared, &expected, allocated))
+        ++failures;
+
+    throwing::shared_ptr<int> nothing;
+    try {
+        failures += *nothing;
+        ++failures;
+    } catch (const throwing::null_ptr_exception<int> &) {
+    }
+    try {
+        failures += nothing.try_deref().value();
+        ++failures;
+    } catch (const throwing::null_ptr_exception<int> &) {
+    }
+
+    return failures + *unique + array[3] - 3;
+}
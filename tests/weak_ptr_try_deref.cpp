@@ -0,0 +1,45 @@
+//          Copyright Claudio Bantaloukas 2017-2018.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include <catch.hpp>
+#include <throwing/shared_ptr.hpp>
+
+TEST_CASE("weak_ptr try_deref on an expired pointer returns an error",
+          "[weak_ptr][try_deref][nullptr]") {
+    throwing::weak_ptr<int> empty;
+    REQUIRE_FALSE(empty.try_deref().has_value());
+
+    throwing::shared_ptr<int> t_ptr = throwing::make_shared<int>(42);
+    throwing::weak_ptr<int> weak = t_ptr;
+    t_ptr.reset();
+    auto result = weak.try_deref();
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE_THROWS_AS(result.value(), throwing::null_ptr_exception<int>&);
+}
+
+TEST_CASE("weak_ptr try_deref keeps the object alive",
+          "[weak_ptr][try_deref]") {
+    throwing::shared_ptr<int> t_ptr = throwing::make_shared<int>(42);
+    throwing::weak_ptr<int> weak = t_ptr;
+    auto result = weak.try_deref();
+    REQUIRE(t_ptr.use_count() == 2);
+
+    t_ptr.reset();
+    REQUIRE_FALSE(weak.expired());
+    REQUIRE(result.value() == 42);
+}
+
+TEST_CASE("weak_ptr value_or and and_then", "[weak_ptr][try_deref]") {
+    throwing::shared_ptr<int> t_ptr = throwing::make_shared<int>(42);
+    throwing::weak_ptr<int> weak = t_ptr;
+    auto self = [](int &i) { return throwing::deref_result<int>(&i); };
+
+    REQUIRE(weak.value_or(7) == 42);
+    REQUIRE(weak.and_then(self).value() == 42);
+
+    t_ptr.reset();
+    REQUIRE(weak.value_or(7) == 7);
+    REQUIRE_FALSE(weak.and_then(self).has_value());
+}